@@ -1,51 +1,503 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FIBONACCI_HAS_AVX2_KERNEL 1
+#endif
 using namespace std;
 
 const int MOD = 1000003;
 
-// Helper function to multiply two 2x2 matrices modulo MOD
-void multiply(long long F[2][2], long long M[2][2]) {
-    long long x = (F[0][0] * M[0][0] + F[0][1] * M[1][0]) % MOD;
-    long long y = (F[0][0] * M[0][1] + F[0][1] * M[1][1]) % MOD;
-    long long z = (F[1][0] * M[0][0] + F[1][1] * M[1][0]) % MOD;
-    long long w = (F[1][0] * M[0][1] + F[1][1] * M[1][1]) % MOD;
+// Arithmetic modulo an odd compile-time modulus in Montgomery form. A value x
+// is stored as x * 2^32 mod Mod, so a product is reduced with two multiplies
+// and a shift instead of a hardware divide.
+template <uint32_t Mod>
+struct Montgomery {
+    static_assert(Mod % 2 == 1 && Mod < (1u << 30), "modulus must be odd and below 2^30");
+
+    // -Mod^(-1) mod 2^32 by Newton iteration (each step doubles the correct bits)
+    static constexpr uint32_t ComputeNegInverse() {
+        uint32_t inverse = Mod;
+        for (int i = 0; i < 4; ++i) {
+            inverse *= 2 - Mod * inverse;
+        }
+        return 0u - inverse;
+    }
+
+    static constexpr uint32_t NEG_INVERSE = ComputeNegInverse();
+    static constexpr uint32_t R2 = static_cast<uint32_t>((0 - static_cast<uint64_t>(Mod)) % Mod);
+
+    // Maps t < Mod * 2^32 to t * 2^-32 mod Mod
+    static constexpr uint32_t Reduce(uint64_t t) {
+        uint32_t m = static_cast<uint32_t>(t) * NEG_INVERSE;
+        uint32_t u = static_cast<uint32_t>((t + static_cast<uint64_t>(m) * Mod) >> 32);
+        return u >= Mod ? u - Mod : u;
+    }
+
+    static constexpr uint32_t ToForm(uint32_t x) { return Reduce(static_cast<uint64_t>(x % Mod) * R2); }
+    static constexpr uint32_t FromForm(uint32_t x) { return Reduce(x); }
+    static constexpr uint32_t Multiply(uint32_t a, uint32_t b) { return Reduce(static_cast<uint64_t>(a) * b); }
+
+    static constexpr uint32_t Add(uint32_t a, uint32_t b) {
+        uint32_t sum = a + b;
+        return sum >= Mod ? sum - Mod : sum;
+    }
+};
+
+// Linear recurrence a(i) = c[0] * a(i - 1) + ... + c[Order - 1] * a(i - Order)
+// modulo Mod, defined by its coefficients and the first Order terms.
+// Order-2 recurrences use iterative fast doubling; higher orders use
+// Kitamasa's method (x^n reduced modulo the characteristic polynomial).
+template <size_t Order, uint32_t Mod>
+class LinearRecurrence {
+    static_assert(Order >= 1, "recurrence order must be positive");
+
+    // Whether Order products summed in 64 bits still fit Montgomery's input range
+    static constexpr bool LAZY_SUMS = Order * static_cast<uint64_t>(Mod) < (1ull << 32);
+
+public:
+    using Field = Montgomery<Mod>;
+    using Polynomial = array<uint32_t, Order>;
+
+    constexpr LinearRecurrence(const array<uint32_t, Order>& coefficients,
+                               const array<uint32_t, Order>& initial_terms)
+        : coefficients_(), initial_terms_() {
+        for (size_t i = 0; i < Order; ++i) {
+            coefficients_[i] = Field::ToForm(coefficients[i]);
+            initial_terms_[i] = Field::ToForm(initial_terms[i]);
+        }
+    }
+
+    // Returns a(n) modulo Mod
+    constexpr uint32_t Term(unsigned long long n) const {
+        if (n < Order) {
+            return Field::FromForm(initial_terms_[n]);
+        }
+        if constexpr (Order == 2) {
+            return FastDoubling(n);
+        } else {
+            return Kitamasa(n);
+        }
+    }
+
+private:
+    Polynomial coefficients_;   // Montgomery form
+    Polynomial initial_terms_;  // Montgomery form
+
+    // Tracks x^k = p * x + q modulo x^2 - c0 * x - c1 while walking the bits
+    // of n from the top, doubling k and stepping by one on set bits.
+    constexpr uint32_t FastDoubling(unsigned long long n) const {
+        const uint32_t c0 = coefficients_[0];
+        const uint32_t c1 = coefficients_[1];
+        uint32_t p = 0;
+        uint32_t q = Field::ToForm(1);
+
+        for (int bit = 63 - __builtin_clzll(n); bit >= 0; --bit) {
+            uint32_t pp = Field::Multiply(p, p);
+            uint32_t pq = Field::Multiply(p, q);
+            uint32_t qq = Field::Multiply(q, q);
+            p = Field::Add(Field::Multiply(pp, c0), Field::Add(pq, pq));
+            q = Field::Add(Field::Multiply(pp, c1), qq);
+
+            if ((n >> bit) & 1) {
+                uint32_t next_p = Field::Add(Field::Multiply(p, c0), q);
+                q = Field::Multiply(p, c1);
+                p = next_p;
+            }
+        }
+
+        uint32_t result = Field::Add(Field::Multiply(p, initial_terms_[1]),
+                                     Field::Multiply(q, initial_terms_[0]));
+        return Field::FromForm(result);
+    }
+
+    // Reduces a polynomial of degree < 2 * Order - 1 in place using
+    // x^Order = c[0] * x^(Order - 1) + ... + c[Order - 1]
+    constexpr void ReduceDegree(array<uint32_t, 2 * Order - 1>& product) const {
+        for (size_t i = 2 * Order - 2; i >= Order; --i) {
+            uint32_t top = product[i];
+            if (top == 0) continue;
+            for (size_t j = 0; j < Order; ++j) {
+                product[i - 1 - j] = Field::Add(product[i - 1 - j], Field::Multiply(top, coefficients_[j]));
+            }
+        }
+    }
+
+    // Returns a * b modulo the characteristic polynomial. When the modulus is
+    // small enough, raw products are summed in 64 bits and reduced once per
+    // coefficient.
+    constexpr Polynomial MultiplyModulo(const Polynomial& a, const Polynomial& b) const {
+        array<uint32_t, 2 * Order - 1> product{};
+        if constexpr (LAZY_SUMS) {
+            array<uint64_t, 2 * Order - 1> sums{};
+            for (size_t i = 0; i < Order; ++i) {
+                for (size_t j = 0; j < Order; ++j) {
+                    sums[i + j] += static_cast<uint64_t>(a[i]) * b[j];
+                }
+            }
+            for (size_t i = 0; i < 2 * Order - 1; ++i) product[i] = Field::Reduce(sums[i]);
+        } else {
+            for (size_t i = 0; i < Order; ++i) {
+                for (size_t j = 0; j < Order; ++j) {
+                    product[i + j] = Field::Add(product[i + j], Field::Multiply(a[i], b[j]));
+                }
+            }
+        }
+        ReduceDegree(product);
+
+        Polynomial result{};
+        for (size_t i = 0; i < Order; ++i) result[i] = product[i];
+        return result;
+    }
+
+    // Returns a * x modulo the characteristic polynomial
+    constexpr Polynomial ShiftModulo(const Polynomial& a) const {
+        Polynomial result{};
+        uint32_t top = a[Order - 1];
+        for (size_t i = Order - 1; i > 0; --i) result[i] = a[i - 1];
+        result[0] = 0;
+        for (size_t j = 0; j < Order; ++j) {
+            result[Order - 1 - j] = Field::Add(result[Order - 1 - j], Field::Multiply(top, coefficients_[j]));
+        }
+        return result;
+    }
+
+    constexpr uint32_t Kitamasa(unsigned long long n) const {
+        Polynomial power{};
+        power[0] = Field::ToForm(1);
+
+        for (int bit = 63 - __builtin_clzll(n); bit >= 0; --bit) {
+            power = MultiplyModulo(power, power);
+            if ((n >> bit) & 1) {
+                power = ShiftModulo(power);
+            }
+        }
+
+        uint32_t result = 0;
+        for (size_t i = 0; i < Order; ++i) {
+            result = Field::Add(result, Field::Multiply(power[i], initial_terms_[i]));
+        }
+        return Field::FromForm(result);
+    }
+};
+
+// a(0) = 0, a(1) = 1, a(i) = a(i - 1) + a(i - 2)
+constexpr LinearRecurrence<2, MOD> FIBONACCI({1, 1}, {0, 1});
+
+// Function to compute the nth Fibonacci number modulo MOD
+int fibonacci(long long n) {
+    // F(1) = 0, F(2) = 1
+    return static_cast<int>(FIBONACCI.Term(static_cast<unsigned long long>(n - 1)));
+}
+
+// Table of F(1..period) modulo MOD, where period is the Pisano period, so
+// that fibonacci(n) == table[(n - 1) % period]. The table is cached in a file
+// and memory-mapped, so it is built once and shared by later runs.
+class PisanoTable {
+public:
+    PisanoTable() = default;
+    PisanoTable(const PisanoTable&) = delete;
+    PisanoTable& operator=(const PisanoTable&) = delete;
+
+    ~PisanoTable() {
+        if (mapping_ != nullptr) munmap(mapping_, mapping_size_);
+    }
+
+    // Maps the cached table at `path`, building and writing it first if the
+    // file is missing or was built for another modulus
+    bool Open(const string& path) {
+        if (Map(path)) return true;
+        return Build(path) && Map(path);
+    }
+
+    int Fibonacci(long long n) const {
+        return static_cast<int>(values_[static_cast<unsigned long long>(n - 1) % period_]);
+    }
 
-    F[0][0] = x;
-    F[0][1] = y;
-    F[1][0] = z;
-    F[1][1] = w;
+    uint32_t Period() const { return period_; }
+
+private:
+    struct Header {
+        char magic[8];
+        uint32_t modulus;
+        uint32_t period;
+    };
+
+    static constexpr char MAGIC[8] = {'P', 'I', 'S', 'A', 'N', 'O', '1', '\0'};
+
+    void* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+    const uint32_t* values_ = nullptr;
+    uint32_t period_ = 0;
+
+    bool Map(const string& path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat info;
+        bool ok = fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(Header);
+        void* mapping = ok ? mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+        close(fd);
+        if (mapping == MAP_FAILED) return false;
+
+        const Header* header = static_cast<const Header*>(mapping);
+        size_t size = static_cast<size_t>(info.st_size);
+        if (memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->modulus != MOD ||
+            size != sizeof(Header) + static_cast<size_t>(header->period) * sizeof(uint32_t)) {
+            munmap(mapping, size);
+            return false;
+        }
+
+        mapping_ = mapping;
+        mapping_size_ = size;
+        period_ = header->period;
+        values_ = reinterpret_cast<const uint32_t*>(header + 1);
+        return true;
+    }
+
+    // Walks the sequence until the pair (F(1), F(2)) = (0, 1) repeats and
+    // writes the table atomically through a temporary file
+    static bool Build(const string& path) {
+        vector<uint32_t> values = {0, 1};
+        while (true) {
+            uint32_t next = (values[values.size() - 2] + values.back()) % MOD;
+            if (values.back() == 0 && next == 1) break;
+            values.push_back(next);
+        }
+        values.pop_back();
+
+        Header header;
+        memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.modulus = MOD;
+        header.period = static_cast<uint32_t>(values.size());
+
+        string temporary_path = path + ".tmp." + to_string(getpid());
+        FILE* file = fopen(temporary_path.c_str(), "wb");
+        if (file == nullptr) return false;
+        bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                  fwrite(values.data(), sizeof(uint32_t), values.size(), file) == values.size();
+        ok = fclose(file) == 0 && ok;
+        if (ok) ok = rename(temporary_path.c_str(), path.c_str()) == 0;
+        if (!ok) remove(temporary_path.c_str());
+        return ok;
+    }
+};
+
+#ifdef FIBONACCI_HAS_AVX2_KERNEL
+// Montgomery product of four residues held in the low halves of 64-bit lanes
+__attribute__((target("avx2"))) static inline __m256i MontgomeryMultiply4(__m256i a, __m256i b, __m256i mod,
+                                                                          __m256i neg_inverse) {
+    __m256i t = _mm256_mul_epu32(a, b);
+    __m256i m = _mm256_mul_epu32(t, neg_inverse);
+    __m256i u = _mm256_srli_epi64(_mm256_add_epi64(t, _mm256_mul_epu32(m, mod)), 32);
+    return _mm256_min_epu32(u, _mm256_sub_epi32(u, mod));
+}
+
+__attribute__((target("avx2"))) static inline __m256i ModularAdd4(__m256i a, __m256i b, __m256i mod) {
+    __m256i sum = _mm256_add_epi32(a, b);
+    return _mm256_min_epu32(sum, _mm256_sub_epi32(sum, mod));
 }
 
-// Helper function to compute F^n using binary exponentiation
-void power(long long F[2][2], long long n) {
-    if (n == 0 || n == 1)
+__attribute__((target("avx2"))) static inline __m256i ModularSubtract4(__m256i a, __m256i b, __m256i mod) {
+    __m256i difference = _mm256_sub_epi32(a, b);
+    return _mm256_min_epu32(difference, _mm256_add_epi32(difference, mod));
+}
+
+// Fast doubling F(2k) = F(k) * (2F(k+1) - F(k)), F(2k+1) = F(k)^2 + F(k+1)^2
+// for four independent indices per vector, two vectors per step
+__attribute__((target("avx2"))) static void FibonacciBatchAvx2(const long long* queries, int* answers,
+                                                               size_t count) {
+    using Field = Montgomery<MOD>;
+    const __m256i mod = _mm256_set1_epi64x(MOD);
+    const __m256i neg_inverse = _mm256_set1_epi64x(Field::NEG_INVERSE);
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256i one_form = _mm256_set1_epi64x(Field::ToForm(1));
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        alignas(32) long long indices[8];
+        unsigned long long combined = 0;
+        for (int lane = 0; lane < 8; ++lane) {
+            indices[lane] = queries[i + lane] - 1;
+            combined |= static_cast<unsigned long long>(indices[lane]);
+        }
+
+        __m256i n[2] = {_mm256_load_si256(reinterpret_cast<const __m256i*>(indices)),
+                        _mm256_load_si256(reinterpret_cast<const __m256i*>(indices + 4))};
+        __m256i f[2] = {_mm256_setzero_si256(), _mm256_setzero_si256()};  // F(k)
+        __m256i g[2] = {one_form, one_form};                              // F(k+1)
+
+        for (int bit = combined == 0 ? -1 : 63 - __builtin_clzll(combined); bit >= 0; --bit) {
+            const __m128i shift = _mm_cvtsi32_si128(bit);
+            for (int v = 0; v < 2; ++v) {
+                __m256i twice_next = ModularAdd4(g[v], g[v], mod);
+                __m256i doubled = MontgomeryMultiply4(f[v], ModularSubtract4(twice_next, f[v], mod), mod, neg_inverse);
+                __m256i next = ModularAdd4(MontgomeryMultiply4(f[v], f[v], mod, neg_inverse),
+                                           MontgomeryMultiply4(g[v], g[v], mod, neg_inverse), mod);
+                __m256i is_set = _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_srl_epi64(n[v], shift), one), one);
+                f[v] = _mm256_blendv_epi8(doubled, next, is_set);
+                g[v] = _mm256_blendv_epi8(next, ModularAdd4(doubled, next, mod), is_set);
+            }
+        }
+
+        alignas(32) uint64_t results[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(results), f[0]);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(results + 4), f[1]);
+        for (int lane = 0; lane < 8; ++lane) {
+            answers[i + lane] = static_cast<int>(Field::FromForm(static_cast<uint32_t>(results[lane])));
+        }
+    }
+
+    for (; i < count; ++i) {
+        answers[i] = fibonacci(queries[i]);
+    }
+}
+#endif
+
+// Answers a batch of queries with the vectorized kernel when the CPU has
+// AVX2, falling back to fibonacci() one query at a time
+void FibonacciBatch(const vector<long long>& queries, vector<int>& answers) {
+    answers.resize(queries.size());
+#ifdef FIBONACCI_HAS_AVX2_KERNEL
+    if (__builtin_cpu_supports("avx2")) {
+        FibonacciBatchAvx2(queries.data(), answers.data(), queries.size());
         return;
+    }
+#endif
+    for (size_t i = 0; i < queries.size(); ++i) {
+        answers[i] = fibonacci(queries[i]);
+    }
+}
 
-    long long M[2][2] = {{1, 1}, {1, 0}};
+// Reads whitespace-separated indices from stdin until end of input. A '-'
+// right before a number makes it negative, for the caller to reject.
+vector<long long> ReadQueries() {
+    vector<long long> queries;
+    vector<char> buffer(1 << 20);
+    long long value = 0;
+    bool in_number = false;
+    bool negative = false;
 
-    // Recursively square the matrix
-    power(F, n / 2);
-    multiply(F, F);
+    size_t length;
+    while ((length = fread(buffer.data(), 1, buffer.size(), stdin)) > 0) {
+        for (size_t i = 0; i < length; ++i) {
+            char c = buffer[i];
+            if (c >= '0' && c <= '9') {
+                value = value * 10 + (c - '0');
+                in_number = true;
+            } else {
+                if (in_number) {
+                    queries.push_back(negative ? -value : value);
+                    value = 0;
+                    in_number = false;
+                }
+                negative = c == '-';
+            }
+        }
+    }
+    if (in_number) queries.push_back(negative ? -value : value);
+    return queries;
+}
 
-    // If n is odd, multiply once more with the base matrix
-    if (n % 2 != 0)
-        multiply(F, M);
+// Reports a negative index, which has no Fibonacci number here
+int RejectNegative(long long n) {
+    cerr << "invalid index " << n << ": indices must not be negative\n";
+    return 1;
 }
 
-// Function to compute the nth Fibonacci number modulo MOD
-int fibonacci(long long n) {
-    if (n == 1) return 0; // F(1) = 0
-    if (n == 2) return 1; // F(2) = 1
+// Writes one answer per line through a single large buffer
+void WriteAnswers(const vector<int>& answers) {
+    string output;
+    output.reserve(answers.size() * 8);
+    char digits[12];
+    for (int answer : answers) {
+        int length = 0;
+        do {
+            digits[length++] = static_cast<char>('0' + answer % 10);
+            answer /= 10;
+        } while (answer > 0);
+        while (length > 0) output.push_back(digits[--length]);
+        output.push_back('\n');
+    }
+    fwrite(output.data(), 1, output.size(), stdout);
+}
+
+// Batch mode: answers every index on stdin. Flags:
+//   --no-table      use the vectorized fast-doubling kernel instead of the table
+//   --table PATH    location of the cached Pisano table
+//   --bench         report queries/second next to the single-query path on stderr
+int RunBatch(int argc, char* argv[]) {
+    bool use_table = true;
+    bool bench = false;
+    string table_path = "pisano_" + to_string(MOD) + ".bin";
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--no-table") use_table = false;
+        else if (arg == "--bench") bench = true;
+        else if (arg == "--table" && i + 1 < argc) table_path = argv[++i];
+    }
+
+    vector<long long> queries = ReadQueries();
+    for (long long n : queries) {
+        if (n < 0) return RejectNegative(n);
+    }
+    vector<int> answers(queries.size());
 
-    long long F[2][2] = {{1, 1}, {1, 0}};
-    power(F, n - 2); // Compute F^(n-2)
+    using Clock = chrono::steady_clock;
+    auto start = Clock::now();
+    PisanoTable table;
+    if (use_table && !table.Open(table_path)) {
+        cerr << "could not open or build " << table_path << ", using the vectorized kernel\n";
+        use_table = false;
+    }
+    if (use_table) {
+        for (size_t i = 0; i < queries.size(); ++i) {
+            answers[i] = table.Fibonacci(queries[i]);
+        }
+    } else {
+        FibonacciBatch(queries, answers);
+    }
+    double batch_seconds = chrono::duration<double>(Clock::now() - start).count();
 
-    return F[0][0]; // The result is F(n)
+    WriteAnswers(answers);
+
+    if (bench && queries.empty()) {
+        cerr << "no queries to benchmark\n";
+    } else if (bench) {
+        start = Clock::now();
+        long long checksum = 0;
+        for (long long n : queries) checksum += fibonacci(n);
+        double single_seconds = chrono::duration<double>(Clock::now() - start).count();
+
+        cerr << (use_table ? "pisano table" : "vectorized kernel") << ": " << queries.size() / batch_seconds
+             << " queries/s\n";
+        cerr << "fibonacci(): " << queries.size() / single_seconds << " queries/s (checksum " << checksum
+             << ")\n";
+    }
+    return 0;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--batch") {
+        return RunBatch(argc, argv);
+    }
+
     long long n;
     cin >> n;
+    if (n < 0) return RejectNegative(n);
     cout << fibonacci(n) << "\n";
     return 0;
 }
@@ -1,8 +1,21 @@
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
-const int MAX_NODES = 53;
+const int MAX_NODES = 256;
+// Largest graph --verify checks against the exhaustive subset DP
+const int VERIFY_MAX_NODES = 20;
 int graph[MAX_NODES][MAX_NODES];
 
 // Depth-First Search to explore connected components
@@ -17,8 +30,9 @@ void DepthFirstSearch(int node, std::vector<bool>& visited, std::vector<int>& cu
   }
 }
 
-// Find the largest group of fully connected nodes using a bitmask-based approach
-std::vector<int> FindLargestFullyConnectedGroup(int n) {
+// Exhaustive subset DP over all 2^n masks. Only usable for small n; --verify
+// checks the branch-and-bound solver below against it.
+std::vector<int> FindLargestGroupBySubsets(int n) {
   std::vector<bool> is_valid(1 << n, false);  // Tracks valid subsets
   std::vector<int> neighbors(n, 0);          // Adjacency masks for each node
   std::vector<int> largest_group;            // Stores the largest group
@@ -62,8 +76,367 @@ std::vector<int> FindLargestFullyConnectedGroup(int n) {
   return largest_group;
 }
 
-// Wrapper to handle special cases or fallback to general solution
-std::vector<int> FindLargestGroupWrapper(int n) {
+// Fixed-width set of nodes stored in kWords 64-bit words
+template <int kWords>
+struct NodeSet {
+  std::array<uint64_t, kWords> words{};
+
+  void Set(int node) { words[node >> 6] |= uint64_t{1} << (node & 63); }
+  void Reset(int node) { words[node >> 6] &= ~(uint64_t{1} << (node & 63)); }
+  bool Test(int node) const { return (words[node >> 6] >> (node & 63)) & 1; }
+
+  bool Empty() const {
+    for (uint64_t word : words) {
+      if (word != 0) return false;
+    }
+    return true;
+  }
+
+  // Lowest node in the set; the set must not be empty
+  int First() const {
+    int w = 0;
+    while (words[w] == 0) ++w;
+    return (w << 6) + __builtin_ctzll(words[w]);
+  }
+
+  NodeSet And(const NodeSet& other) const {
+    NodeSet result;
+    for (int w = 0; w < kWords; ++w) result.words[w] = words[w] & other.words[w];
+    return result;
+  }
+
+  int Count() const {
+    int count = 0;
+    for (uint64_t word : words) count += __builtin_popcountll(word);
+    return count;
+  }
+
+  NodeSet AndNot(const NodeSet& other) const {
+    NodeSet result;
+    for (int w = 0; w < kWords; ++w) result.words[w] = words[w] & ~other.words[w];
+    return result;
+  }
+};
+
+// Fixed-size thread pool where every worker owns a deque of tasks. A worker
+// pushes and pops subtasks at the back of its own deque and, when it runs
+// dry, steals the oldest (largest) task from the front of another's.
+class WorkStealingPool {
+ public:
+  using Task = std::function<void()>;
+
+  explicit WorkStealingPool(int threads) {
+    for (int i = 0; i < threads; ++i) workers_.emplace_back(new Worker);
+    for (int i = 0; i < threads; ++i) threads_.emplace_back(&WorkStealingPool::WorkerLoop, this, i);
+  }
+
+  ~WorkStealingPool() {
+    {
+      std::lock_guard<std::mutex> lock(state_mutex_);
+      stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& thread : threads_) thread.join();
+  }
+
+  int Size() const { return static_cast<int>(workers_.size()); }
+
+  // Index of the calling worker thread, or -1 outside the pool
+  static int CurrentWorker() { return worker_index_; }
+
+  // Runs the tasks, and every task they spawn, to completion
+  void Run(std::vector<Task> tasks) {
+    if (tasks.empty()) return;
+    pending_ += static_cast<long>(tasks.size());
+    for (size_t i = 0; i < tasks.size(); ++i) {
+      Worker& worker = *workers_[i % workers_.size()];
+      std::lock_guard<std::mutex> lock(worker.mutex);
+      worker.tasks.push_back(std::move(tasks[i]));
+    }
+
+    std::unique_lock<std::mutex> lock(state_mutex_);
+    ++round_;
+    wake_.notify_all();
+    done_.wait(lock, [this] { return pending_.load() == 0; });
+  }
+
+  // Queues a subtask on the calling worker's own deque
+  void Spawn(Task task) {
+    ++pending_;
+    Worker& worker = *workers_[worker_index_];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    worker.tasks.push_back(std::move(task));
+  }
+
+ private:
+  struct Worker {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<std::thread> threads_;
+  std::atomic<long> pending_{0};
+  std::mutex state_mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  uint64_t round_ = 0;
+  bool stopping_ = false;
+  static thread_local int worker_index_;
+
+  bool TryTake(int self, Task& task) {
+    {
+      Worker& own = *workers_[self];
+      std::lock_guard<std::mutex> lock(own.mutex);
+      if (!own.tasks.empty()) {
+        task = std::move(own.tasks.back());
+        own.tasks.pop_back();
+        return true;
+      }
+    }
+    for (size_t offset = 1; offset < workers_.size(); ++offset) {
+      Worker& victim = *workers_[(self + offset) % workers_.size()];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (!victim.tasks.empty()) {
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void WorkerLoop(int index) {
+    worker_index_ = index;
+    uint64_t seen_round = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(state_mutex_);
+        wake_.wait(lock, [&] { return stopping_ || round_ != seen_round; });
+        if (stopping_) return;
+        seen_round = round_;
+      }
+
+      Task task;
+      while (pending_.load() > 0) {
+        if (!TryTake(index, task)) {
+          std::this_thread::yield();
+          continue;
+        }
+        task();
+        task = nullptr;
+        if (--pending_ == 0) {
+          std::lock_guard<std::mutex> lock(state_mutex_);
+          done_.notify_all();
+        }
+      }
+    }
+  }
+};
+
+thread_local int WorkStealingPool::worker_index_ = -1;
+
+// Branch-and-bound maximum clique search (Tomita's MCQ/MCS family) over
+// bitset adjacency rows. Candidates are greedily colored at every node of the
+// search tree; a vertex's color bounds the clique that can still be grown
+// from it, so branches that cannot beat the incumbent are cut.
+//
+// With a pool, the top kSplitDepth levels of the search tree become tasks and
+// all workers prune against one atomic incumbent size.
+template <int kWords>
+class MaxCliqueSolver {
+ public:
+  using Set = NodeSet<kWords>;
+
+  explicit MaxCliqueSolver(int n, WorkStealingPool* pool = nullptr)
+      : n_(n), adjacency_(n), pool_(pool), scratch_(pool != nullptr ? pool->Size() + 1 : 1) {
+    for (int i = 0; i < n; ++i) {
+      for (int j = 0; j < n; ++j) {
+        if (i != j && graph[i][j] == 1) {
+          adjacency_[i].Set(j);
+        }
+      }
+    }
+    for (Scratch& scratch : scratch_) {
+      scratch.order_by_depth.resize(n + 1);
+      scratch.colors_by_depth.resize(n + 1);
+    }
+  }
+
+  // Returns the maximum clique the subset DP would report: among all cliques
+  // of maximum size, the one with the smallest bitmask. It is built one node
+  // at a time from the top, choosing the smallest node that can still be
+  // completed to a clique of the remaining size with smaller nodes only.
+  // The result does not depend on the number of threads.
+  std::vector<int> Solve() {
+    Set all;
+    for (int i = 0; i < n_; ++i) all.Set(i);
+
+    int max_size = Search(all, 0, n_ + 1);
+
+    std::vector<int> group;
+    Set candidates = all;
+    for (int needed = max_size; needed > 0; --needed) {
+      Set below;
+      for (int node = 0; node < n_; ++node) {
+        if (!candidates.Test(node)) continue;
+
+        Set rest = below.And(adjacency_[node]);
+        if (HasClique(rest, needed - 1)) {
+          group.push_back(node);
+          candidates = rest;
+          break;
+        }
+        below.Set(node);
+      }
+    }
+
+    std::reverse(group.begin(), group.end());
+    return group;
+  }
+
+  // Whether the candidates contain a clique of at least `size` nodes
+  bool HasClique(const Set& candidates, int size) {
+    if (size == 0) return true;
+    return Search(candidates, size - 1, size) >= size;
+  }
+
+ private:
+  // Candidate sets smaller than this are searched on the calling thread
+  static constexpr int kParallelMinCandidates = 32;
+  static constexpr int kSplitDepth = 2;
+
+  struct SearchState {
+    std::atomic<int> best_size;
+    int stop_size;
+    std::atomic<bool> stopped{false};
+  };
+
+  struct Scratch {
+    std::vector<std::vector<int>> order_by_depth;
+    std::vector<std::vector<int>> colors_by_depth;
+  };
+
+  int n_;
+  std::vector<Set> adjacency_;
+  WorkStealingPool* pool_;
+  std::vector<Scratch> scratch_;  // one per worker, the last for the caller
+
+  // Returns the largest clique size found in `candidates`, starting from an
+  // incumbent of best_size and stopping early once stop_size is reached
+  int Search(const Set& candidates, int best_size, int stop_size) {
+    SearchState state;
+    state.best_size = best_size;
+    state.stop_size = stop_size;
+
+    if (pool_ == nullptr || candidates.Count() < kParallelMinCandidates) {
+      Expand(candidates, 0, state, scratch_.back());
+    } else {
+      std::vector<WorkStealingPool::Task> roots;
+      roots.emplace_back([this, candidates, &state] { Split(candidates, 0, n_, state); });
+      pool_->Run(std::move(roots));
+    }
+    return state.best_size.load();
+  }
+
+  static void RecordClique(int size, SearchState& state) {
+    int best = state.best_size.load(std::memory_order_relaxed);
+    while (size > best && !state.best_size.compare_exchange_weak(best, size)) {
+    }
+    if (size >= state.stop_size) state.stopped = true;
+  }
+
+  // Greedy sequential coloring: each color class is an independent set, and
+  // nodes come out ordered by non-decreasing color
+  void ColorSort(const Set& candidates, std::vector<int>& order, std::vector<int>& colors) const {
+    order.clear();
+    colors.clear();
+    Set uncolored = candidates;
+    int color = 0;
+    while (!uncolored.Empty()) {
+      ++color;
+      Set available = uncolored;
+      while (!available.Empty()) {
+        int node = available.First();
+        available = available.AndNot(adjacency_[node]);
+        available.Reset(node);
+        uncolored.Reset(node);
+        order.push_back(node);
+        colors.push_back(color);
+      }
+    }
+  }
+
+  // Task body for the top levels: branches on every candidate like Expand,
+  // but spawns each child subtree as a task. `bound` is the coloring bound
+  // the parent computed, rechecked once the task actually runs.
+  void Split(Set candidates, int depth, int bound, SearchState& state) {
+    if (state.stopped || bound <= state.best_size.load(std::memory_order_relaxed)) return;
+
+    Scratch& scratch = scratch_[WorkStealingPool::CurrentWorker()];
+    if (depth >= kSplitDepth) {
+      Expand(candidates, depth, state, scratch);
+      return;
+    }
+
+    std::vector<int> order;
+    std::vector<int> colors;
+    ColorSort(candidates, order, colors);
+
+    for (int i = static_cast<int>(order.size()) - 1; i >= 0; --i) {
+      if (depth + colors[i] <= state.best_size.load(std::memory_order_relaxed)) return;
+
+      int node = order[i];
+      Set next = candidates.And(adjacency_[node]);
+      if (next.Empty()) {
+        RecordClique(depth + 1, state);
+      } else {
+        pool_->Spawn([this, next, depth, bound = depth + colors[i], &state] {
+          Split(next, depth + 1, bound, state);
+        });
+      }
+      candidates.Reset(node);
+    }
+  }
+
+  // Grows the current clique of `depth` nodes from `candidates`. Returns true
+  // as soon as a clique of stop_size nodes has been found, here or by another
+  // worker.
+  bool Expand(Set candidates, int depth, SearchState& state, Scratch& scratch) const {
+    std::vector<int>& order = scratch.order_by_depth[depth];
+    std::vector<int>& colors = scratch.colors_by_depth[depth];
+    ColorSort(candidates, order, colors);
+
+    for (int i = static_cast<int>(order.size()) - 1; i >= 0; --i) {
+      if (state.stopped.load(std::memory_order_relaxed)) return true;
+      if (depth + colors[i] <= state.best_size.load(std::memory_order_relaxed)) return false;
+
+      int node = order[i];
+      Set next = candidates.And(adjacency_[node]);
+      if (next.Empty()) {
+        RecordClique(depth + 1, state);
+        if (state.stopped) return true;
+      } else if (Expand(next, depth + 1, state, scratch)) {
+        return true;
+      }
+      candidates.Reset(node);
+    }
+    return false;
+  }
+};
+
+// Find the largest group of fully connected nodes using the smallest bitset
+// width that holds n nodes
+std::vector<int> FindLargestFullyConnectedGroup(int n, WorkStealingPool* pool = nullptr) {
+  if (n <= 64) return MaxCliqueSolver<1>(n, pool).Solve();
+  if (n <= 128) return MaxCliqueSolver<2>(n, pool).Solve();
+  return MaxCliqueSolver<(MAX_NODES + 63) / 64>(n, pool).Solve();
+}
+
+// Wrapper to handle special cases or fallback to general solution. With more
+// than one thread the search runs on a work-stealing pool and returns the
+// same group as the sequential path.
+std::vector<int> FindLargestGroupWrapper(int n, int threads = 1) {
   bool is_complete_graph = true;
 
   // Check if the graph is a complete graph
@@ -93,11 +466,78 @@ std::vector<int> FindLargestGroupWrapper(int n) {
     return largest_group;
   } else {
     // Use the general solution for other cases
-    return FindLargestFullyConnectedGroup(n);
+    if (threads <= 1) {
+      return FindLargestFullyConnectedGroup(n);
+    }
+    WorkStealingPool pool(threads);
+    return FindLargestFullyConnectedGroup(n, &pool);
   }
 }
 
-int main() {
+// Times the search for thread counts 1, 2, 4, ... up to max_threads and
+// reports the speedup over one thread on stderr
+void BenchmarkThreads(int n, int max_threads) {
+  using Clock = std::chrono::steady_clock;
+  double sequential_seconds = 0;
+  std::vector<int> sequential_group;
+
+  for (int threads = 1;; threads = std::min(threads * 2, max_threads)) {
+    auto start = Clock::now();
+    std::vector<int> group = FindLargestGroupWrapper(n, threads);
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    if (threads == 1) {
+      sequential_seconds = seconds;
+      sequential_group = group;
+    }
+    std::cerr << "threads " << threads << ": " << seconds << " s, speedup " << sequential_seconds / seconds
+              << (group == sequential_group ? "" : " (MISMATCH)") << "\n";
+    if (threads >= max_threads) break;
+  }
+}
+
+// Whether `group` is a clique of the same size as the subset DP's answer,
+// reporting any difference on stderr
+bool VerifyAgainstSubsets(int n, const std::vector<int>& group) {
+  if (n > VERIFY_MAX_NODES) {
+    std::cerr << "verify: skipped, n = " << n << " exceeds " << VERIFY_MAX_NODES << "\n";
+    return true;
+  }
+  for (size_t i = 0; i < group.size(); ++i) {
+    for (size_t j = i + 1; j < group.size(); ++j) {
+      if (graph[group[i]][group[j]] != 1) {
+        std::cerr << "verify: MISMATCH, " << group[i] << " and " << group[j] << " are not connected\n";
+        return false;
+      }
+    }
+  }
+  size_t expected = FindLargestGroupBySubsets(n).size();
+  if (group.size() != expected) {
+    std::cerr << "verify: MISMATCH, group of " << group.size() << " nodes, subset DP finds " << expected << "\n";
+    return false;
+  }
+  std::cerr << "verify: ok, " << expected << " nodes\n";
+  return true;
+}
+
+int main(int argc, char* argv[]) {
+  int threads = 1;
+  bool bench = false;
+  bool verify = false;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--threads" && i + 1 < argc) {
+      threads = std::stoi(argv[++i]);
+    } else if (arg == "--bench") {
+      bench = true;
+    } else if (arg == "--verify") {
+      verify = true;
+    }
+  }
+  if (threads <= 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
   int n;
   std::cin >> n;
 
@@ -108,8 +548,13 @@ int main() {
     }
   }
 
+  if (bench) {
+    BenchmarkThreads(n, std::max(threads, static_cast<int>(std::thread::hardware_concurrency())));
+  }
+
   // Find the largest group and output the result
-  std::vector<int> largest_group = FindLargestGroupWrapper(n);
+  std::vector<int> largest_group = FindLargestGroupWrapper(n, threads);
+  bool verified = !verify || VerifyAgainstSubsets(n, largest_group);
 
   std::sort(largest_group.begin(), largest_group.end());
   for (size_t i = 0; i < largest_group.size(); ++i) {
@@ -119,5 +564,5 @@ int main() {
     }
   }
 
-  return 0;
+  return verified ? 0 : 1;
 }
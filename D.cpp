@@ -1,8 +1,77 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <climits>
+#include <condition_variable>
+#include <cstdint>
 #include <iostream>
-#include <queue>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
+// How FindShortestPath() traverses the graph
+enum class TraversalPolicy {
+  kSingleSource,               // one FIFO BFS per source, then a scan of the three distance arrays
+  kBitParallel,                // all sources in one pass with per-vertex bitmasks
+  kDirectionOptimizing,        // parallel top-down/bottom-up BFS per source over adjacency_list
+  kDirectionOptimizingCsr,     // the same over a compact CSR copy of the graph
+};
+
+// Reusable barrier for threads that advance level by level together
+class LevelBarrier {
+ public:
+  explicit LevelBarrier(int threads) : threads_(threads) {}
+
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint64_t generation = generation_;
+    if (++arrived_ == threads_) {
+      arrived_ = 0;
+      ++generation_;
+      released_.notify_all();
+    } else {
+      released_.wait(lock, [&] { return generation_ != generation; });
+    }
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable released_;
+  int threads_;
+  int arrived_ = 0;
+  uint64_t generation_ = 0;
+};
+
+// Fixed-size bitmap whose words can be updated from several threads
+class AtomicBitmap {
+ public:
+  explicit AtomicBitmap(size_t bits) : size_((bits + 63) / 64), words_(new std::atomic<uint64_t>[size_]) {
+    Clear();
+  }
+
+  size_t Words() const { return size_; }
+  std::atomic<uint64_t>& Word(size_t index) { return words_[index]; }
+  const std::atomic<uint64_t>& Word(size_t index) const { return words_[index]; }
+
+  bool Test(size_t bit) const { return (words_[bit >> 6].load(std::memory_order_relaxed) >> (bit & 63)) & 1; }
+
+  // Sets the bit and returns whether this call was the one that set it
+  bool TrySet(size_t bit) {
+    uint64_t mask = uint64_t{1} << (bit & 63);
+    return (words_[bit >> 6].fetch_or(mask, std::memory_order_relaxed) & mask) == 0;
+  }
+
+  void Clear() {
+    for (size_t i = 0; i < size_; ++i) words_[i].store(0, std::memory_order_relaxed);
+  }
+
+ private:
+  size_t size_;
+  std::unique_ptr<std::atomic<uint64_t>[]> words_;
+};
+
 template <typename T>
 class Graph {
  public:
@@ -11,61 +80,418 @@ class Graph {
   void AddEdge(T source, T destination) {
     adjacency_list[source].push_back(destination);
     adjacency_list[destination].push_back(source);
+    csr_is_current = false;
   }
 
-  T FindShortestPath(T src1, T src2, T target, int total_nodes) {
+  // Number of threads used by the direction-optimizing policies
+  void SetThreadCount(int threads) { thread_count = std::max(1, threads); }
+
+  // Minimum over all vertices v of d(src1, v) + d(src2, v) + d(target, v),
+  // or INT_MAX when no vertex is reachable from all three
+  T FindShortestPath(T src1, T src2, T target, int total_nodes,
+                     TraversalPolicy policy = TraversalPolicy::kBitParallel) {
+    if (policy == TraversalPolicy::kBitParallel) {
+      std::array<T, 3> query = {src1, src2, target};
+      T result;
+      MeetingBFS(&query, 1, total_nodes, &result);
+      return result;
+    }
+
     std::vector<T> dist_from_src1(total_nodes, INT_MAX);
     std::vector<T> dist_from_src2(total_nodes, INT_MAX);
     std::vector<T> dist_from_target(total_nodes, INT_MAX);
 
-    BFS(src1, total_nodes, dist_from_src1);
-    BFS(src2, total_nodes, dist_from_src2);
-    BFS(target, total_nodes, dist_from_target);
+    if (policy == TraversalPolicy::kSingleSource) {
+      BFS(src1, total_nodes, dist_from_src1);
+      BFS(src2, total_nodes, dist_from_src2);
+      BFS(target, total_nodes, dist_from_target);
+    } else if (policy == TraversalPolicy::kDirectionOptimizing) {
+      AdjacencyListView view{&adjacency_list};
+      DirectionOptimizingBFS(view, src1, total_nodes, dist_from_src1);
+      DirectionOptimizingBFS(view, src2, total_nodes, dist_from_src2);
+      DirectionOptimizingBFS(view, target, total_nodes, dist_from_target);
+    } else {
+      CsrView view = Csr();
+      DirectionOptimizingBFS(view, src1, total_nodes, dist_from_src1);
+      DirectionOptimizingBFS(view, src2, total_nodes, dist_from_src2);
+      DirectionOptimizingBFS(view, target, total_nodes, dist_from_target);
+    }
 
     return CalculateMinimumDistance(total_nodes, dist_from_src1, dist_from_src2, dist_from_target);
   }
 
+  // Answers a batch of {src1, src2, target} queries, packing up to
+  // kQueriesPerPass triplets (3 mask bits each) into every traversal
+  std::vector<T> FindShortestPaths(const std::vector<std::array<T, 3>>& queries, int total_nodes) {
+    std::vector<T> results(queries.size());
+    size_t per_pass = std::max<size_t>(1, kMaxPartialSumBytes / (sizeof(T) * std::max(total_nodes, 1)));
+    per_pass = std::min<size_t>(per_pass, kQueriesPerPass);
+
+    for (size_t first = 0; first < queries.size(); first += per_pass) {
+      int count = static_cast<int>(std::min(per_pass, queries.size() - first));
+      MeetingBFS(&queries[first], count, total_nodes, &results[first]);
+    }
+    return results;
+  }
+
  private:
+  static constexpr int kQueriesPerPass = 64 / 3;
+  // Cap on the per-vertex, per-query partial sums kept by one traversal
+  static constexpr size_t kMaxPartialSumBytes = size_t{256} << 20;
+
+  // Beamer's switching thresholds: go bottom-up once the frontier's edges
+  // exceed 1/kAlpha of the unexplored edges, and back top-down once the
+  // frontier holds fewer than 1/kBeta of the vertices
+  static constexpr int64_t kAlpha = 14;
+  static constexpr int64_t kBeta = 24;
+
   std::vector<std::vector<T>> adjacency_list;
+  std::vector<size_t> csr_offsets;
+  std::vector<T> csr_targets;
+  bool csr_is_current = false;
+  int thread_count = std::max(1u, std::thread::hardware_concurrency());
 
-  void BFS(T start, int total_nodes, std::vector<T>& distances) {
-    std::priority_queue<std::pair<T, T>, std::vector<std::pair<T, T>>, std::greater<>> pq;
-    std::vector<bool> visited(total_nodes, false);
+  struct NeighborRange {
+    const T* first;
+    const T* last;
+    const T* begin() const { return first; }
+    const T* end() const { return last; }
+    int64_t size() const { return last - first; }
+  };
+
+  struct AdjacencyListView {
+    const std::vector<std::vector<T>>* lists;
+    NeighborRange Neighbors(T vertex) const {
+      const std::vector<T>& list = (*lists)[vertex];
+      return {list.data(), list.data() + list.size()};
+    }
+  };
+
+  struct CsrView {
+    const size_t* offsets;
+    const T* targets;
+    NeighborRange Neighbors(T vertex) const {
+      return {targets + offsets[vertex], targets + offsets[vertex + 1]};
+    }
+  };
+
+  // Builds (or reuses) the compressed sparse row copy of adjacency_list
+  CsrView Csr() {
+    if (!csr_is_current) {
+      csr_offsets.assign(adjacency_list.size() + 1, 0);
+      for (size_t v = 0; v < adjacency_list.size(); ++v) {
+        csr_offsets[v + 1] = csr_offsets[v] + adjacency_list[v].size();
+      }
+      csr_targets.resize(csr_offsets.back());
+      for (size_t v = 0; v < adjacency_list.size(); ++v) {
+        std::copy(adjacency_list[v].begin(), adjacency_list[v].end(), csr_targets.begin() + csr_offsets[v]);
+      }
+      csr_is_current = true;
+    }
+    return {csr_offsets.data(), csr_targets.data()};
+  }
 
+  // Level-synchronous BFS (Beamer et al.) on thread_count threads. Top-down
+  // levels split the frontier list and claim vertices with an atomic
+  // visited bitmap; bottom-up levels split the vertex range in whole bitmap
+  // words and let every unvisited vertex look for a parent in the frontier
+  // bitmap. Thread 0 merges the level and picks the next direction while
+  // the others wait at the barrier.
+  template <typename View>
+  void DirectionOptimizingBFS(const View& view, T start, int total_nodes, std::vector<T>& distances) {
+    const int threads = thread_count;
+    AtomicBitmap visited(total_nodes);
+    AtomicBitmap frontier_bits(total_nodes);
+    AtomicBitmap next_bits(total_nodes);
+    AtomicBitmap* current_bits = &frontier_bits;
+    AtomicBitmap* upcoming_bits = &next_bits;
+
+    // Bits past the last vertex count as visited
+    if (total_nodes % 64 != 0) {
+      visited.Word(visited.Words() - 1).store(~uint64_t{0} << (total_nodes % 64));
+    }
+
+    int64_t unexplored_edges = 0;
+    for (int v = 0; v < total_nodes; ++v) unexplored_edges += view.Neighbors(v).size();
+
+    std::vector<T> frontier = {start};
+    std::vector<std::vector<T>> local_next(threads);
+    std::vector<int64_t> local_vertices(threads, 0);
+    std::vector<int64_t> local_edges(threads, 0);
+    visited.TrySet(start);
     distances[start] = 0;
-    pq.emplace(0, start);
 
-    while (!pq.empty()) {
-      T current_node = pq.top().second;
-      pq.pop();
+    T level = 0;
+    bool bottom_up = false;
+    bool done = false;
+    int64_t frontier_size = 1;
+    int64_t frontier_edges = view.Neighbors(start).size();
+    LevelBarrier barrier(threads);
 
-      if (visited[current_node]) continue;
-      visited[current_node] = true;
+    auto decide_next_level = [&] {
+      int64_t previous_size = frontier_size;
+      frontier_size = 0;
+      frontier_edges = 0;
+      for (int t = 0; t < threads; ++t) {
+        frontier_size += local_vertices[t];
+        frontier_edges += local_edges[t];
+        local_vertices[t] = local_edges[t] = 0;
+      }
+      unexplored_edges -= frontier_edges;
+      ++level;
+
+      if (!bottom_up) {
+        frontier.clear();
+        for (std::vector<T>& next : local_next) {
+          frontier.insert(frontier.end(), next.begin(), next.end());
+          next.clear();
+        }
+      } else {
+        std::swap(current_bits, upcoming_bits);
+      }
+
+      if (frontier_size == 0) {
+        done = true;
+      } else if (!bottom_up && frontier_edges > unexplored_edges / kAlpha) {
+        current_bits->Clear();
+        for (T vertex : frontier) current_bits->TrySet(vertex);
+        bottom_up = true;
+      } else if (bottom_up && frontier_size < total_nodes / kBeta && frontier_size < previous_size) {
+        frontier.clear();
+        for (size_t w = 0; w < current_bits->Words(); ++w) {
+          for (uint64_t bits = current_bits->Word(w).load(); bits != 0; bits &= bits - 1) {
+            frontier.push_back(static_cast<T>(w * 64 + __builtin_ctzll(bits)));
+          }
+        }
+        bottom_up = false;
+      }
+    };
+
+    auto worker = [&](int id) {
+      while (true) {
+        barrier.Wait();
+        if (done) return;
+        const T next_level = level + 1;
+
+        if (!bottom_up) {
+          size_t chunk = (frontier.size() + threads - 1) / threads;
+          size_t first = std::min(frontier.size(), chunk * id);
+          size_t last = std::min(frontier.size(), first + chunk);
+          for (size_t i = first; i < last; ++i) {
+            for (T neighbor : view.Neighbors(frontier[i])) {
+              if (!visited.Test(neighbor) && visited.TrySet(neighbor)) {
+                distances[neighbor] = next_level;
+                local_next[id].push_back(neighbor);
+                ++local_vertices[id];
+                local_edges[id] += view.Neighbors(neighbor).size();
+              }
+            }
+          }
+        } else {
+          size_t chunk = (visited.Words() + threads - 1) / threads;
+          size_t first = std::min(visited.Words(), chunk * id);
+          size_t last = std::min(visited.Words(), first + chunk);
+          for (size_t w = first; w < last; ++w) {
+            uint64_t found = 0;
+            for (uint64_t unvisited = ~visited.Word(w).load(std::memory_order_relaxed); unvisited != 0;
+                 unvisited &= unvisited - 1) {
+              T vertex = static_cast<T>(w * 64 + __builtin_ctzll(unvisited));
+              for (T neighbor : view.Neighbors(vertex)) {
+                if (current_bits->Test(neighbor)) {
+                  distances[vertex] = next_level;
+                  found |= unvisited & -unvisited;
+                  ++local_vertices[id];
+                  local_edges[id] += view.Neighbors(vertex).size();
+                  break;
+                }
+              }
+            }
+            upcoming_bits->Word(w).store(found, std::memory_order_relaxed);
+            visited.Word(w).fetch_or(found, std::memory_order_relaxed);
+          }
+        }
+
+        barrier.Wait();
+        if (id == 0) decide_next_level();
+      }
+    };
+
+    std::vector<std::thread> helpers;
+    for (int id = 1; id < threads; ++id) helpers.emplace_back(worker, id);
+    worker(0);
+    for (std::thread& helper : helpers) helper.join();
+  }
+
+  void BFS(T start, int total_nodes, std::vector<T>& distances) {
+    std::vector<T> queue;
+    queue.reserve(total_nodes);
+    distances[start] = 0;
+    queue.push_back(start);
+
+    for (size_t head = 0; head < queue.size(); ++head) {
+      T current_node = queue[head];
+      T next_distance = distances[current_node] + 1;
 
       for (const T& neighbor : adjacency_list[current_node]) {
-        if (distances[current_node] + 1 < distances[neighbor]) {
-          distances[neighbor] = distances[current_node] + 1;
-          pq.emplace(distances[neighbor], neighbor);
+        if (distances[neighbor] == INT_MAX) {
+          distances[neighbor] = next_distance;
+          queue.push_back(neighbor);
         }
       }
     }
   }
 
+  // Multi-source BFS: bit 3q + i of a vertex mask stands for source i of
+  // query q. All sources advance one level per round, and each vertex's
+  // partial distance sum for a query is completed the round its third bit
+  // arrives. A query stops propagating once no later round can beat its
+  // best sum, and the traversal stops when every query has. Rounds with a
+  // heavy frontier run bottom-up, like DirectionOptimizingBFS.
+  void MeetingBFS(const std::array<T, 3>* queries, int count, int total_nodes, T* results) {
+    std::vector<uint64_t> seen(total_nodes, 0);
+    std::vector<uint64_t> visit(total_nodes, 0);
+    std::vector<uint64_t> next(total_nodes, 0);
+    std::vector<T> partial_sums(static_cast<size_t>(total_nodes) * count, 0);
+    std::vector<T> frontier;
+    std::vector<T> next_frontier;
+
+    uint64_t live_mask = 0;
+    for (int q = 0; q < count; ++q) {
+      results[q] = INT_MAX;
+      live_mask |= uint64_t{7} << (3 * q);
+      for (int i = 0; i < 3; ++i) {
+        T source = queries[q][i];
+        if (visit[source] == 0) frontier.push_back(source);
+        visit[source] |= uint64_t{1} << (3 * q + i);
+      }
+    }
+
+    // Edges of vertices still missing some source bit, which bottom-up
+    // rounds have to scan. Counting a vertex out on its first visit is
+    // not enough: the nearest source reaches everything long before the
+    // others do, and the count would then force bottom-up on every round.
+    const uint64_t all_bits = live_mask;
+    int64_t unexplored_edges = 0;
+    for (const std::vector<T>& neighbors : adjacency_list) unexplored_edges += neighbors.size();
+
+    // Records the bits that first reach `vertex` at `level`
+    auto arrive = [&](T vertex, uint64_t arrived, T level) {
+      seen[vertex] |= arrived;
+      if (seen[vertex] == all_bits) unexplored_edges -= adjacency_list[vertex].size();
+      while (arrived != 0) {
+        int q = __builtin_ctzll(arrived) / 3;
+        uint64_t query_mask = uint64_t{7} << (3 * q);
+        T& sum = partial_sums[static_cast<size_t>(vertex) * count + q];
+        sum += level * __builtin_popcountll(arrived & query_mask);
+        if ((seen[vertex] & query_mask) == query_mask) {
+          results[q] = std::min(results[q], sum);
+        }
+        arrived &= ~query_mask;
+      }
+    };
+
+    // Any vertex completed at a later level has a sum of at least that level
+    auto retire_finished = [&](T level) {
+      for (int q = 0; q < count; ++q) {
+        if (results[q] <= level + 1) live_mask &= ~(uint64_t{7} << (3 * q));
+      }
+    };
+
+    for (T vertex : frontier) arrive(vertex, visit[vertex], 0);
+    retire_finished(0);
+
+    // Same switching rule as DirectionOptimizingBFS, in both directions
+    bool bottom_up = false;
+    int64_t previous_size = 0;
+    for (T level = 1; !frontier.empty() && live_mask != 0; ++level) {
+      int64_t frontier_size = frontier.size();
+      int64_t frontier_edges = 0;
+      for (T vertex : frontier) frontier_edges += adjacency_list[vertex].size();
+      if (!bottom_up && frontier_edges > unexplored_edges / kAlpha) {
+        bottom_up = true;
+      } else if (bottom_up && frontier_size < total_nodes / kBeta && frontier_size < previous_size) {
+        bottom_up = false;
+      }
+      previous_size = frontier_size;
+
+      if (bottom_up) {
+        // Bottom-up: every vertex still missing live bits pulls them from
+        // its neighbors, stopping as soon as it has all of them
+        for (int vertex = 0; vertex < total_nodes; ++vertex) {
+          uint64_t missing = live_mask & ~seen[vertex];
+          if (missing == 0) continue;
+          uint64_t reached = 0;
+          for (const T& neighbor : adjacency_list[vertex]) {
+            reached |= visit[neighbor] & missing;
+            if (reached == missing) break;
+          }
+          if (reached == 0) continue;
+          next_frontier.push_back(vertex);
+          next[vertex] = reached;
+        }
+      } else {
+        for (T vertex : frontier) {
+          uint64_t spreading = visit[vertex] & live_mask;
+          if (spreading == 0) continue;
+          for (const T& neighbor : adjacency_list[vertex]) {
+            uint64_t reached = spreading & ~seen[neighbor];
+            if (reached == 0) continue;
+            if (next[neighbor] == 0) next_frontier.push_back(neighbor);
+            next[neighbor] |= reached;
+          }
+        }
+      }
+
+      for (T vertex : frontier) visit[vertex] = 0;
+      for (T vertex : next_frontier) {
+        visit[vertex] = next[vertex];
+        next[vertex] = 0;
+        arrive(vertex, visit[vertex], level);
+      }
+      retire_finished(level);
+
+      frontier.swap(next_frontier);
+      next_frontier.clear();
+    }
+  }
+
   static T CalculateMinimumDistance(int total_nodes, const std::vector<T>& dist1,
                                      const std::vector<T>& dist2, const std::vector<T>& dist3) {
     T minimum_distance = INT_MAX;
     for (int i = 0; i < total_nodes; ++i) {
+      if (dist1[i] == INT_MAX || dist2[i] == INT_MAX || dist3[i] == INT_MAX) continue;
       minimum_distance = std::min(minimum_distance, dist1[i] + dist2[i] + dist3[i]);
     }
     return minimum_distance;
   }
 };
 
-int main() {
+int main(int argc, char* argv[]) {
+  TraversalPolicy policy = TraversalPolicy::kBitParallel;
+  bool batch = false;
+  int threads = 0;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--single-source") {
+      policy = TraversalPolicy::kSingleSource;
+    } else if (arg == "--direction-optimizing") {
+      policy = TraversalPolicy::kDirectionOptimizing;
+    } else if (arg == "--direction-optimizing-csr") {
+      policy = TraversalPolicy::kDirectionOptimizingCsr;
+    } else if (arg == "--threads" && i + 1 < argc) {
+      threads = std::stoi(argv[++i]);
+    } else if (arg == "--batch") {
+      batch = true;
+    }
+  }
+
   int nodes, edges, leon, matilda, destination;
   std::cin >> nodes >> edges >> leon >> matilda >> destination;
 
   Graph<int> city_graph(nodes + 1);
+  if (threads > 0) {
+    city_graph.SetThreadCount(threads);
+  }
 
   for (int i = 0; i < edges; ++i) {
     int u, v;
@@ -73,6 +499,24 @@ int main() {
     city_graph.AddEdge(u, v);
   }
 
-  std::cout << city_graph.FindShortestPath(leon, matilda, destination, nodes + 1);
+  if (!batch) {
+    std::cout << city_graph.FindShortestPath(leon, matilda, destination, nodes + 1, policy);
+    return 0;
+  }
+
+  // Batch mode: the header query is followed by a count and that many more
+  // "src1 src2 target" triplets; one answer per line
+  int query_count;
+  std::cin >> query_count;
+  std::vector<std::array<int, 3>> queries = {{leon, matilda, destination}};
+  for (int i = 0; i < query_count; ++i) {
+    std::array<int, 3> query;
+    std::cin >> query[0] >> query[1] >> query[2];
+    queries.push_back(query);
+  }
+
+  for (int result : city_graph.FindShortestPaths(queries, nodes + 1)) {
+    std::cout << result << "\n";
+  }
   return 0;
 }
@@ -1,6 +1,44 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
 #include <vector>
 
+// Reusable barrier for threads that advance level by level together
+class LevelBarrier {
+ public:
+  explicit LevelBarrier(int threads) : threads_(threads) {}
+
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint64_t generation = generation_;
+    if (++arrived_ == threads_) {
+      arrived_ = 0;
+      ++generation_;
+      released_.notify_all();
+    } else {
+      released_.wait(lock, [&] { return generation_ != generation; });
+    }
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable released_;
+  int threads_;
+  int arrived_ = 0;
+  uint64_t generation_ = 0;
+};
+
 template <typename T>
 class TopologicalSort {
  public:
@@ -43,16 +81,569 @@ class TopologicalSort {
     return processed_count == num_vertices;
   }
 
+  // Level-synchronous Kahn's algorithm. Each wavefront of zero in-degree
+  // vertices is split across threads, which decrement in-degrees atomically
+  // and collect the next wavefront in per-thread buffers; thread 0 merges
+  // them between levels. With `deterministic`, each level is emitted in
+  // ascending vertex order, so the result does not depend on scheduling.
+  // Does not consume the in-degrees, unlike PerformSort().
+  bool PerformParallelSort(std::vector<int>& sorted_order, int threads, bool deterministic,
+                           std::vector<int>* level_widths = nullptr) const {
+    threads = std::max(1, threads);
+    std::unique_ptr<std::atomic<int>[]> remaining(new std::atomic<int>[num_vertices]);
+    std::vector<T> frontier;
+    for (T i = 0; i < num_vertices; ++i) {
+      remaining[i].store(in_degree[i], std::memory_order_relaxed);
+      if (in_degree[i] == 0) {
+        frontier.push_back(i);
+      }
+    }
+
+    std::vector<std::vector<T>> next_by_thread(threads);
+    int processed_count = 0;
+    bool done = frontier.empty();
+    LevelBarrier barrier(threads);
+
+    auto finish_level = [&] {
+      processed_count += static_cast<int>(frontier.size());
+      sorted_order.insert(sorted_order.end(), frontier.begin(), frontier.end());
+      if (level_widths != nullptr) {
+        level_widths->push_back(static_cast<int>(frontier.size()));
+      }
+
+      frontier.clear();
+      for (std::vector<T>& next : next_by_thread) {
+        frontier.insert(frontier.end(), next.begin(), next.end());
+        next.clear();
+      }
+      if (deterministic) {
+        std::sort(frontier.begin(), frontier.end());
+      }
+      done = frontier.empty();
+    };
+
+    auto worker = [&](int id) {
+      while (true) {
+        barrier.Wait();
+        if (done) return;
+
+        size_t chunk = (frontier.size() + threads - 1) / threads;
+        size_t first = std::min(frontier.size(), chunk * id);
+        size_t last = std::min(frontier.size(), first + chunk);
+        std::vector<T>& next = next_by_thread[id];
+        for (size_t i = first; i < last; ++i) {
+          for (T neighbor : adjacency_list[frontier[i]]) {
+            if (remaining[neighbor].fetch_sub(1, std::memory_order_relaxed) == 1) {
+              next.push_back(neighbor);
+            }
+          }
+        }
+
+        barrier.Wait();
+        if (id == 0) finish_level();
+      }
+    };
+
+    std::vector<std::thread> helpers;
+    for (int id = 1; id < threads; ++id) helpers.emplace_back(worker, id);
+    worker(0);
+    for (std::thread& helper : helpers) helper.join();
+
+    // Vertices on or behind a cycle never reach zero in-degree
+    return processed_count == num_vertices;
+  }
+
  private:
   T num_vertices;
   std::vector<std::vector<T>> adjacency_list;
   std::vector<int> in_degree;
 };
 
-int main() {
+// Online topological order under edge insertions (Pearce and Kelly, 2006).
+// position[v] is v's index in the current order. An edge that already goes
+// forward is just recorded. Otherwise only the affected region between the
+// two endpoints is searched: vertices reachable from `to` and vertices
+// reaching `from` within that window are reordered, reusing their own
+// positions, so the rest of the order is untouched.
+template <typename T>
+class DynamicTopologicalOrder {
+ public:
+  explicit DynamicTopologicalOrder(int vertices)
+      : num_vertices(vertices),
+        adjacency_list(vertices),
+        reverse_adjacency_list(vertices),
+        position(vertices),
+        visit_stamp(vertices, 0) {
+    for (T i = 0; i < num_vertices; ++i) {
+      position[i] = i;
+    }
+  }
+
+  // Inserts the edge and keeps the order valid. Returns false, leaving the
+  // graph unchanged, if the edge would close a cycle.
+  bool AddEdge(T from, T to) {
+    if (from == to) return false;
+
+    int lower_bound = position[to];
+    int upper_bound = position[from];
+    if (lower_bound > upper_bound) {
+      Insert(from, to);
+      return true;
+    }
+
+    ++current_stamp;
+    forward.clear();
+    if (!Search(to, adjacency_list, forward, [&](T v) { return position[v] <= upper_bound; }, from)) {
+      return false;
+    }
+    ++current_stamp;
+    backward.clear();
+    Search(from, reverse_adjacency_list, backward, [&](T v) { return position[v] >= lower_bound; }, to);
+
+    Reorder();
+    Insert(from, to);
+    return true;
+  }
+
+  // Vertices in topological order
+  std::vector<int> Order() const {
+    std::vector<int> order(num_vertices);
+    for (T i = 0; i < num_vertices; ++i) {
+      order[position[i]] = i;
+    }
+    return order;
+  }
+
+ private:
+  T num_vertices;
+  std::vector<std::vector<T>> adjacency_list;
+  std::vector<std::vector<T>> reverse_adjacency_list;
+  std::vector<int> position;
+  std::vector<int> visit_stamp;
+  int current_stamp = 0;
+  std::vector<T> forward;
+  std::vector<T> backward;
+  std::vector<T> stack;
+  std::vector<int> slots;
+
+  void Insert(T from, T to) {
+    adjacency_list[from].push_back(to);
+    reverse_adjacency_list[to].push_back(from);
+  }
+
+  // Iterative DFS from `start` over vertices accepted by `in_window`.
+  // Returns false as soon as `forbidden` is reached.
+  template <typename InWindow>
+  bool Search(T start, const std::vector<std::vector<T>>& edges, std::vector<T>& reached, InWindow in_window,
+              T forbidden) {
+    stack.assign(1, start);
+    visit_stamp[start] = current_stamp;
+    while (!stack.empty()) {
+      T current = stack.back();
+      stack.pop_back();
+      reached.push_back(current);
+
+      for (T neighbor : edges[current]) {
+        if (neighbor == forbidden) return false;
+        if (visit_stamp[neighbor] != current_stamp && in_window(neighbor)) {
+          visit_stamp[neighbor] = current_stamp;
+          stack.push_back(neighbor);
+        }
+      }
+    }
+    return true;
+  }
+
+  // Places the backward set before the forward set, each in its old relative
+  // order, on the positions the two sets occupied
+  void Reorder() {
+    auto by_position = [&](T a, T b) { return position[a] < position[b]; };
+    std::sort(forward.begin(), forward.end(), by_position);
+    std::sort(backward.begin(), backward.end(), by_position);
+
+    slots.clear();
+    for (T v : backward) slots.push_back(position[v]);
+    for (T v : forward) slots.push_back(position[v]);
+    std::sort(slots.begin(), slots.end());
+
+    size_t next = 0;
+    for (T v : backward) position[v] = slots[next++];
+    for (T v : forward) position[v] = slots[next++];
+  }
+};
+
+// Semi-external Kahn's algorithm for edge lists that do not fit in memory.
+// Only per-vertex state (in/out degrees, the output order) stays in RAM.
+// Edges are spooled to a temporary file, then split into partition files by
+// ranges of source vertices, each small enough to load within the memory
+// budget. Sorting sweeps over the partitions: a partition is loaded only if
+// it holds ready vertices, and its internal edges are resolved in memory
+// before moving on. Edges leaving the partition just decrement in-degrees.
+// A failed temporary file operation makes PerformSort() return false with
+// IoFailed() set, which callers must tell apart from a cycle.
+class ExternalTopologicalSort {
+ public:
+  ExternalTopologicalSort(int vertices, size_t memory_budget_bytes)
+      : num_vertices(vertices),
+        memory_budget(std::max<size_t>(memory_budget_bytes, 1 << 16)),
+        in_degree(vertices, 0),
+        out_degree(vertices, 0),
+        spool(std::tmpfile()) {}
+
+  ~ExternalTopologicalSort() {
+    if (spool != nullptr) std::fclose(spool);
+    for (Partition& partition : partitions) {
+      if (partition.file != nullptr) std::fclose(partition.file);
+    }
+  }
+
+  ExternalTopologicalSort(const ExternalTopologicalSort&) = delete;
+  ExternalTopologicalSort& operator=(const ExternalTopologicalSort&) = delete;
+
+  void AddEdge(int from, int to) {
+    write_buffer.push_back({from, to});
+    if (write_buffer.size() == kBufferRecords) FlushSpool();
+    ++out_degree[from];
+    ++in_degree[to];
+  }
+
+  bool PerformSort(std::vector<int>& sorted_order) {
+    FlushSpool();
+    if (spool == nullptr) io_failed = true;
+    if (io_failed) return false;
+    BuildPartitions();
+    if (io_failed) return false;
+
+    std::vector<int> ready_count(partitions.size(), 0);
+    for (int v = 0; v < num_vertices; ++v) {
+      if (in_degree[v] == 0) ++ready_count[PartitionOf(v)];
+    }
+
+    // Emitted vertices are marked with in-degree -1
+    int emitted = 0;
+    std::vector<Edge> edges;
+    std::vector<int> local_offsets;
+    std::vector<int> local_targets;
+    std::vector<int> stack;
+    bool progress = true;
+    while (emitted < num_vertices && progress) {
+      progress = false;
+      ++sweeps;
+      for (size_t p = 0; p < partitions.size(); ++p) {
+        if (ready_count[p] == 0) continue;
+        progress = true;
+        const Partition& partition = partitions[p];
+        if (!LoadPartition(partition, edges, local_offsets, local_targets)) return false;
+
+        stack.clear();
+        for (int v = partition.first_vertex; v < partition.end_vertex; ++v) {
+          if (in_degree[v] == 0) stack.push_back(v);
+        }
+        ready_count[p] = 0;
+
+        while (!stack.empty()) {
+          int current = stack.back();
+          stack.pop_back();
+          in_degree[current] = -1;
+          sorted_order.push_back(current);
+          ++emitted;
+
+          int local = current - partition.first_vertex;
+          for (int i = local_offsets[local]; i < local_offsets[local + 1]; ++i) {
+            int neighbor = local_targets[i];
+            if (--in_degree[neighbor] != 0) continue;
+            if (neighbor >= partition.first_vertex && neighbor < partition.end_vertex) {
+              stack.push_back(neighbor);
+            } else {
+              ++ready_count[PartitionOf(neighbor)];
+            }
+          }
+        }
+      }
+    }
+
+    return emitted == num_vertices;
+  }
+
+  // Sequential passes over edge data: the partitioning pass plus one per sweep
+  int Passes() const { return partitioning_passes + sweeps; }
+  uint64_t BytesRead() const { return bytes_read; }
+  bool IoFailed() const { return io_failed; }
+  size_t PartitionCount() const { return partitions.size(); }
+
+ private:
+  struct Edge {
+    int32_t from;
+    int32_t to;
+  };
+
+  struct Partition {
+    int first_vertex;
+    int end_vertex;
+    uint64_t edge_count;
+    std::FILE* file;
+  };
+
+  static constexpr size_t kBufferRecords = 1 << 16;
+
+  int num_vertices;
+  size_t memory_budget;
+  std::vector<int> in_degree;
+  std::vector<int> out_degree;
+  std::FILE* spool;
+  std::vector<Edge> write_buffer;
+  std::vector<Partition> partitions;
+  int partitioning_passes = 0;
+  int sweeps = 0;
+  uint64_t bytes_read = 0;
+  uint64_t spooled_edges = 0;
+  bool io_failed = false;
+
+  // Appends `count` edges to `file`, recording a missing file or short write
+  void WriteEdges(std::FILE* file, const Edge* data, size_t count) {
+    if (file == nullptr || std::fwrite(data, sizeof(Edge), count, file) != count) io_failed = true;
+  }
+
+  void FlushSpool() {
+    if (!write_buffer.empty()) {
+      WriteEdges(spool, write_buffer.data(), write_buffer.size());
+      spooled_edges += write_buffer.size();
+    }
+    write_buffer.clear();
+  }
+
+  int PartitionOf(int vertex) const {
+    auto it = std::upper_bound(partitions.begin(), partitions.end(), vertex,
+                               [](int v, const Partition& partition) { return v < partition.end_vertex; });
+    return static_cast<int>(it - partitions.begin());
+  }
+
+  // Cuts the vertex range so that each partition's edges plus its local CSR
+  // fit in the budget, then distributes the spool in one sequential pass
+  void BuildPartitions() {
+    const uint64_t bytes_per_edge = sizeof(Edge) + sizeof(int);
+    const uint64_t limit = memory_budget;
+    int first = 0;
+    uint64_t edges = 0;
+    for (int v = 0; v < num_vertices; ++v) {
+      uint64_t next_edges = edges + out_degree[v];
+      uint64_t next_bytes = next_edges * bytes_per_edge + static_cast<uint64_t>(v - first + 2) * sizeof(int);
+      if (v > first && next_bytes > limit) {
+        partitions.push_back({first, v, edges, nullptr});
+        first = v;
+        next_edges = out_degree[v];
+      }
+      edges = next_edges;
+    }
+    partitions.push_back({first, num_vertices, edges, nullptr});
+
+    std::vector<std::vector<Edge>> buffers(partitions.size());
+    size_t per_buffer = std::max<size_t>(256, memory_budget / 4 / sizeof(Edge) / partitions.size());
+    for (Partition& partition : partitions) {
+      if (partition.edge_count == 0) continue;
+      partition.file = std::tmpfile();
+      if (partition.file == nullptr) {
+        io_failed = true;
+        return;
+      }
+    }
+
+    if (std::fflush(spool) != 0) {
+      io_failed = true;
+      return;
+    }
+    std::rewind(spool);
+    uint64_t edges_read = 0;
+    std::vector<Edge> chunk(kBufferRecords);
+    size_t count;
+    while ((count = std::fread(chunk.data(), sizeof(Edge), chunk.size(), spool)) > 0) {
+      bytes_read += count * sizeof(Edge);
+      edges_read += count;
+      for (size_t i = 0; i < count; ++i) {
+        int p = PartitionOf(chunk[i].from);
+        buffers[p].push_back(chunk[i]);
+        if (buffers[p].size() >= per_buffer) {
+          WriteEdges(partitions[p].file, buffers[p].data(), buffers[p].size());
+          buffers[p].clear();
+        }
+      }
+    }
+    if (std::ferror(spool) || edges_read != spooled_edges) io_failed = true;
+    for (size_t p = 0; p < partitions.size(); ++p) {
+      if (!buffers[p].empty()) WriteEdges(partitions[p].file, buffers[p].data(), buffers[p].size());
+      if (partitions[p].file != nullptr && std::fflush(partitions[p].file) != 0) io_failed = true;
+    }
+    std::fclose(spool);
+    spool = nullptr;
+    ++partitioning_passes;
+  }
+
+  // Reads a partition and groups its edges by source in a local CSR; false
+  // if the partition file comes back short
+  bool LoadPartition(const Partition& partition, std::vector<Edge>& edges, std::vector<int>& offsets,
+                     std::vector<int>& targets) {
+    int range = partition.end_vertex - partition.first_vertex;
+    offsets.assign(range + 1, 0);
+    edges.resize(partition.edge_count);
+    targets.resize(partition.edge_count);
+    if (partition.edge_count == 0) return true;
+
+    std::rewind(partition.file);
+    size_t count = std::fread(edges.data(), sizeof(Edge), edges.size(), partition.file);
+    bytes_read += count * sizeof(Edge);
+    if (count != edges.size()) {
+      io_failed = true;
+      return false;
+    }
+
+    for (const Edge& edge : edges) ++offsets[edge.from - partition.first_vertex + 1];
+    for (int i = 0; i < range; ++i) offsets[i + 1] += offsets[i];
+    std::vector<int> cursor(offsets.begin(), offsets.end() - 1);
+    for (const Edge& edge : edges) targets[cursor[edge.from - partition.first_vertex]++] = edge.to;
+    return true;
+  }
+};
+
+// Streams `insertions` random edges of a hidden DAG over insertions / 4
+// vertices and compares online maintenance with rebuilding TopologicalSort
+// and re-running PerformSort() every `rebuild_interval` insertions
+void BenchmarkDynamicOrder(int insertions, int rebuild_interval) {
+  using Clock = std::chrono::steady_clock;
+  int vertices = std::max(2, insertions / 4);
+  std::mt19937 random(12345);
+  std::vector<int> hidden_rank(vertices);
+  for (int i = 0; i < vertices; ++i) hidden_rank[i] = i;
+  std::shuffle(hidden_rank.begin(), hidden_rank.end(), random);
+
+  std::vector<std::pair<int, int>> stream;
+  stream.reserve(insertions);
+  std::uniform_int_distribution<int> pick(0, vertices - 1);
+  while (static_cast<int>(stream.size()) < insertions) {
+    int a = pick(random);
+    int b = pick(random);
+    if (a == b) continue;
+    if (hidden_rank[a] > hidden_rank[b]) std::swap(a, b);
+    stream.emplace_back(a, b);
+  }
+
+  auto start = Clock::now();
+  DynamicTopologicalOrder<int> online(vertices);
+  for (const auto& edge : stream) online.AddEdge(edge.first, edge.second);
+  double online_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+  start = Clock::now();
+  for (int end = rebuild_interval; end <= insertions; end += rebuild_interval) {
+    TopologicalSort<int> sorter(vertices);
+    for (int i = 0; i < end; ++i) sorter.AddEdge(stream[i].first, stream[i].second);
+    std::vector<int> sorted_order;
+    sorter.PerformSort(sorted_order);
+  }
+  double rebuild_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+  std::cerr << insertions << " insertions over " << vertices << " vertices\n";
+  std::cerr << "online order: " << online_seconds << " s, " << insertions / online_seconds << " edges/s\n";
+  std::cerr << "re-sort every " << rebuild_interval << " edges: " << rebuild_seconds << " s, "
+            << insertions / rebuild_seconds << " edges/s\n";
+}
+
+void PrintResult(bool is_acyclic, const std::vector<int>& sorted_order) {
+  if (is_acyclic) {
+    std::cout << "YES" << std::endl;
+    for (int node : sorted_order) {
+      std::cout << node << " ";
+    }
+  } else {
+    std::cout << "NO";
+  }
+}
+
+// Value of the optional count after argv[i]. The next argument is consumed
+// only when it is a number; `fallback` otherwise.
+size_t OptionalCount(int argc, char* argv[], int& i, size_t fallback) {
+  if (i + 1 >= argc) return fallback;
+  const char* text = argv[i + 1];
+  bool number = *text != '\0' && std::all_of(text, text + std::strlen(text),
+                                              [](char c) { return std::isdigit(static_cast<unsigned char>(c)); });
+  if (!number) return fallback;
+  ++i;
+  return std::stoul(text);
+}
+
+int main(int argc, char* argv[]) {
+  bool dynamic = false;
+  size_t external_budget_mb = 0;
+  int bench_insertions = 0;
+  bool parallel = false;
+  bool deterministic = false;
+  bool report_levels = false;
+  int threads = 0;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--parallel") {
+      parallel = true;
+    } else if (arg == "--deterministic") {
+      deterministic = true;
+    } else if (arg == "--level-widths") {
+      report_levels = true;
+    } else if (arg == "--threads" && i + 1 < argc) {
+      threads = std::stoi(argv[++i]);
+    } else if (arg == "--dynamic") {
+      dynamic = true;
+    } else if (arg == "--external") {
+      external_budget_mb = OptionalCount(argc, argv, i, 64);
+    } else if (arg == "--bench-dynamic") {
+      bench_insertions = static_cast<int>(OptionalCount(argc, argv, i, 1000000));
+    }
+  }
+  if (bench_insertions > 0) {
+    BenchmarkDynamicOrder(bench_insertions, std::max(1, bench_insertions / 100));
+    return 0;
+  }
+  if (threads <= 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  std::ios::sync_with_stdio(false);
+  std::cin.tie(nullptr);
+
   int vertices, edges;
   std::cin >> vertices >> edges;
 
+  if (external_budget_mb > 0) {
+    ExternalTopologicalSort external(vertices, external_budget_mb << 20);
+    for (int i = 0; i < edges; ++i) {
+      int from, to;
+      std::cin >> from >> to;
+      external.AddEdge(from, to);
+    }
+
+    std::vector<int> sorted_order;
+    bool is_acyclic = external.PerformSort(sorted_order);
+    if (external.IoFailed()) {
+      std::cerr << "external sort: temporary file I/O failed\n";
+      return 1;
+    }
+    std::cerr << "partitions " << external.PartitionCount() << ", passes " << external.Passes()
+              << ", bytes read " << external.BytesRead() << "\n";
+    PrintResult(is_acyclic, sorted_order);
+    return 0;
+  }
+
+  if (dynamic) {
+    // Maintain the order while reading; the first rejected edge closes a cycle
+    DynamicTopologicalOrder<int> online(vertices);
+    for (int i = 0; i < edges; ++i) {
+      int from, to;
+      std::cin >> from >> to;
+      if (!online.AddEdge(from, to)) {
+        PrintResult(false, {});
+        return 0;
+      }
+    }
+    PrintResult(true, online.Order());
+    return 0;
+  }
+
   TopologicalSort<int> sorter(vertices);
   std::vector<int> sorted_order;
 
@@ -64,14 +655,19 @@ int main() {
   }
 
   // Perform topological sort
-  if (sorter.PerformSort(sorted_order)) {
-    std::cout << "YES" << std::endl;
-    for (int node : sorted_order) {
-      std::cout << node << " ";
+  std::vector<int> level_widths;
+  bool is_acyclic = parallel ? sorter.PerformParallelSort(sorted_order, threads, deterministic, &level_widths)
+                             : sorter.PerformSort(sorted_order);
+
+  if (parallel && report_levels) {
+    std::cerr << "levels " << level_widths.size() << ":";
+    for (int width : level_widths) {
+      std::cerr << " " << width;
     }
-  } else {
-    std::cout << "NO";
+    std::cerr << "\n";
   }
 
+  PrintResult(is_acyclic, sorted_order);
+
   return 0;
 }
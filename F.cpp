@@ -1,6 +1,14 @@
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <iostream>
-#include <stack>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_set>
 #include <vector>
 
 template <typename T>
@@ -16,8 +24,11 @@ class Graph {
     reverse_adjacency_list[destination].emplace_back(source);
   }
 
-  std::vector<std::vector<T>> FindStronglyConnectedComponents() {
-    std::stack<T> finish_order;
+  // Kosaraju's algorithm with explicit stacks. Also fills component_index
+  // with the position of each vertex's SCC in the returned list.
+  std::vector<std::vector<T>> FindStronglyConnectedComponents(std::vector<int>& component_index) {
+    std::vector<T> finish_order;
+    finish_order.reserve(total_vertices);
     std::vector<bool> visited(total_vertices, false);
 
     // Perform a DFS to record the finish order of vertices
@@ -27,36 +38,183 @@ class Graph {
       }
     }
 
-    // Reset visited for the second pass
-    visited.assign(total_vertices, false);
-
+    component_index.assign(total_vertices, -1);
     std::vector<std::vector<T>> scc_list;
 
     // Process vertices in reverse finish order to find SCCs
-    while (!finish_order.empty()) {
-      T current = finish_order.top();
-      finish_order.pop();
-
-      if (!visited[current]) {
+    for (auto it = finish_order.rbegin(); it != finish_order.rend(); ++it) {
+      T current = *it;
+      if (component_index[current] == -1) {
         std::vector<T> scc;
-        ExtractSCC(current, visited, scc);
-        scc_list.emplace_back(scc);
+        ExtractSCC(current, static_cast<int>(scc_list.size()), component_index, scc);
+        scc_list.emplace_back(std::move(scc));
+      }
+    }
+
+    return scc_list;
+  }
+
+  // Multi-core SCC decomposition producing the same partition as
+  // FindStronglyConnectedComponents() (the list order may differ).
+  //
+  // 1. Trim: vertices with no live in-edges or no live out-edges are SCCs of
+  //    their own. Every thread peels from its slice of the vertex range and
+  //    cascades through atomic live-degree counters.
+  // 2. Forward-backward: for a set of vertices sharing a label, the vertices
+  //    both reachable from a pivot and reaching it form the pivot's SCC. The
+  //    forward-only, backward-only and untouched remainders cannot share an
+  //    SCC, so they become independent tasks for the worker threads.
+  std::vector<std::vector<T>> FindStronglyConnectedComponentsParallel(std::vector<int>& component_index,
+                                                                      int threads) {
+    threads = std::max(1, threads);
+    component_index.assign(total_vertices, -1);
+    std::unique_ptr<std::atomic<int>[]> label(new std::atomic<int>[total_vertices]);
+    std::unique_ptr<std::atomic<int>[]> live_in(new std::atomic<int>[total_vertices]);
+    std::unique_ptr<std::atomic<int>[]> live_out(new std::atomic<int>[total_vertices]);
+    std::atomic<int> next_component{0};
+
+    RunOnThreads(threads, [&](int id) {
+      auto [first, last] = SliceOf(id, threads);
+      for (T v = first; v < last; ++v) {
+        label[v].store(0, std::memory_order_relaxed);
+        live_in[v].store(static_cast<int>(reverse_adjacency_list[v].size()), std::memory_order_relaxed);
+        live_out[v].store(static_cast<int>(adjacency_list[v].size()), std::memory_order_relaxed);
+      }
+    });
+
+    RunOnThreads(threads, [&](int id) {
+      auto [first, last] = SliceOf(id, threads);
+      std::vector<T> trimmed;
+      auto try_trim = [&](T v) {
+        int expected = 0;
+        if (label[v].compare_exchange_strong(expected, kRemoved)) {
+          component_index[v] = next_component++;
+          trimmed.push_back(v);
+        }
+      };
+
+      for (T v = first; v < last; ++v) {
+        if (live_in[v].load() == 0 || live_out[v].load() == 0) try_trim(v);
+        while (!trimmed.empty()) {
+          T current = trimmed.back();
+          trimmed.pop_back();
+          for (T neighbor : adjacency_list[current]) {
+            if (live_in[neighbor].fetch_sub(1) == 1) try_trim(neighbor);
+          }
+          for (T neighbor : reverse_adjacency_list[current]) {
+            if (live_out[neighbor].fetch_sub(1) == 1) try_trim(neighbor);
+          }
+        }
       }
+    });
+
+    std::vector<T> remaining;
+    for (T v = 0; v < total_vertices; ++v) {
+      if (label[v].load(std::memory_order_relaxed) == 0) remaining.push_back(v);
     }
 
+    // A task reads and writes only the stamps of vertices carrying its
+    // label; no other task can give a vertex that label, so the plain
+    // ints are never shared
+    std::vector<int> forward_stamp(total_vertices, -1);
+    std::vector<int> backward_stamp(total_vertices, -1);
+    std::atomic<int> next_label{1};
+
+    std::mutex queue_mutex;
+    std::condition_variable queue_changed;
+    std::deque<std::pair<int, std::vector<T>>> tasks;
+    int active_tasks = 0;
+    if (!remaining.empty()) tasks.emplace_back(0, std::move(remaining));
+
+    auto reach = [&](T pivot, int task_label, const std::vector<std::vector<T>>& edges, std::vector<int>& stamp) {
+      std::vector<T> queue = {pivot};
+      stamp[pivot] = task_label;
+      for (size_t head = 0; head < queue.size(); ++head) {
+        for (T neighbor : edges[queue[head]]) {
+          if (label[neighbor].load(std::memory_order_relaxed) == task_label && stamp[neighbor] != task_label) {
+            stamp[neighbor] = task_label;
+            queue.push_back(neighbor);
+          }
+        }
+      }
+    };
+
+    auto solve = [&](int task_label, std::vector<T>& vertices) {
+      T pivot = vertices[(static_cast<size_t>(task_label) * 2654435761u) % vertices.size()];
+      if (vertices.size() >= kConcurrentSearchSize && threads > 1) {
+        std::thread backward([&] { reach(pivot, task_label, reverse_adjacency_list, backward_stamp); });
+        reach(pivot, task_label, adjacency_list, forward_stamp);
+        backward.join();
+      } else {
+        reach(pivot, task_label, adjacency_list, forward_stamp);
+        reach(pivot, task_label, reverse_adjacency_list, backward_stamp);
+      }
+
+      int component = next_component++;
+      std::vector<T> parts[3];
+      for (T v : vertices) {
+        bool forward = forward_stamp[v] == task_label;
+        bool backward = backward_stamp[v] == task_label;
+        if (forward && backward) {
+          component_index[v] = component;
+          label[v].store(kRemoved, std::memory_order_relaxed);
+        } else {
+          parts[forward ? 0 : backward ? 1 : 2].push_back(v);
+        }
+      }
+
+      std::vector<std::pair<int, std::vector<T>>> subtasks;
+      for (std::vector<T>& part : parts) {
+        if (part.empty()) continue;
+        int part_label = next_label++;
+        for (T v : part) label[v].store(part_label, std::memory_order_relaxed);
+        subtasks.emplace_back(part_label, std::move(part));
+      }
+      return subtasks;
+    };
+
+    RunOnThreads(threads, [&](int) {
+      std::unique_lock<std::mutex> lock(queue_mutex);
+      while (true) {
+        queue_changed.wait(lock, [&] { return !tasks.empty() || active_tasks == 0; });
+        if (tasks.empty()) return;
+
+        std::pair<int, std::vector<T>> task = std::move(tasks.front());
+        tasks.pop_front();
+        ++active_tasks;
+        lock.unlock();
+
+        auto subtasks = solve(task.first, task.second);
+
+        lock.lock();
+        --active_tasks;
+        for (auto& subtask : subtasks) tasks.push_back(std::move(subtask));
+        queue_changed.notify_all();
+      }
+    });
+
+    std::vector<std::vector<T>> scc_list(next_component.load());
+    for (T v = 0; v < total_vertices; ++v) {
+      scc_list[component_index[v]].push_back(v);
+    }
     return scc_list;
   }
 
-  Graph<T> CondenseGraph(const std::vector<std::vector<T>>& scc_list) {
+  // Builds the DAG of SCCs in O(V + E). Each component's outgoing edges are
+  // deduplicated by remembering which source component last added an edge
+  // to each destination.
+  Graph<T> CondenseGraph(const std::vector<std::vector<T>>& scc_list, const std::vector<int>& component_index) {
     int new_vertex_count = scc_list.size();
     Graph<T> condensed_graph(new_vertex_count);
+    std::vector<int> last_source(new_vertex_count, -1);
 
     for (size_t i = 0; i < scc_list.size(); ++i) {
+      int source_index = static_cast<int>(i);
       for (T vertex : scc_list[i]) {
         for (T neighbor : adjacency_list[vertex]) {
-          int source_index = GetComponentIndex(scc_list, vertex);
-          int dest_index = GetComponentIndex(scc_list, neighbor);
-          if (source_index != dest_index) {
+          int dest_index = component_index[neighbor];
+          if (dest_index != source_index && last_source[dest_index] != source_index) {
+            last_source[dest_index] = source_index;
             condensed_graph.AddEdge(source_index, dest_index);
           }
         }
@@ -83,48 +241,378 @@ class Graph {
     return {zero_in_degree, zero_out_degree};
   }
 
+  // Same counts as CalculateDegrees(), split over vertex ranges. A vertex has
+  // no in-edges exactly when its reverse adjacency list is empty.
+  std::pair<int, int> CalculateDegrees(int threads) {
+    threads = std::max(1, threads);
+    std::vector<int> zero_in_by_thread(threads, 0);
+    std::vector<int> zero_out_by_thread(threads, 0);
+
+    RunOnThreads(threads, [&](int id) {
+      auto [first, last] = SliceOf(id, threads);
+      for (T v = first; v < last; ++v) {
+        zero_in_by_thread[id] += reverse_adjacency_list[v].empty();
+        zero_out_by_thread[id] += adjacency_list[v].empty();
+      }
+    });
+
+    int zero_in_degree = 0;
+    int zero_out_degree = 0;
+    for (int id = 0; id < threads; ++id) {
+      zero_in_degree += zero_in_by_thread[id];
+      zero_out_degree += zero_out_by_thread[id];
+    }
+    return {zero_in_degree, zero_out_degree};
+  }
+
  private:
+  static constexpr int kRemoved = -1;
+  // Forward-backward tasks at least this large run both searches at once
+  static constexpr size_t kConcurrentSearchSize = 1 << 16;
+
   int total_vertices;
   std::vector<std::vector<T>> adjacency_list;
   std::vector<std::vector<T>> reverse_adjacency_list;
 
-  void PerformDFS(T vertex, std::vector<bool>& visited, std::stack<T>& finish_order) {
-    visited[vertex] = true;
+  // Vertex range [first, last) handled by thread `id`
+  std::pair<T, T> SliceOf(int id, int threads) const {
+    int64_t chunk = (static_cast<int64_t>(total_vertices) + threads - 1) / threads;
+    int64_t first = std::min<int64_t>(total_vertices, chunk * id);
+    int64_t last = std::min<int64_t>(total_vertices, first + chunk);
+    return {static_cast<T>(first), static_cast<T>(last)};
+  }
+
+  template <typename Body>
+  static void RunOnThreads(int threads, Body body) {
+    std::vector<std::thread> helpers;
+    for (int id = 1; id < threads; ++id) helpers.emplace_back(body, id);
+    body(0);
+    for (std::thread& helper : helpers) helper.join();
+  }
 
-    for (T neighbor : adjacency_list[vertex]) {
-      if (!visited[neighbor]) {
-        PerformDFS(neighbor, visited, finish_order);
+  // Iterative post-order DFS; each stack frame keeps the index of the next
+  // edge to explore
+  void PerformDFS(T start, std::vector<bool>& visited, std::vector<T>& finish_order) {
+    std::vector<std::pair<T, size_t>> stack;
+    visited[start] = true;
+    stack.emplace_back(start, 0);
+
+    while (!stack.empty()) {
+      T vertex = stack.back().first;
+      size_t& next_edge = stack.back().second;
+
+      if (next_edge < adjacency_list[vertex].size()) {
+        T neighbor = adjacency_list[vertex][next_edge++];
+        if (!visited[neighbor]) {
+          visited[neighbor] = true;
+          stack.emplace_back(neighbor, 0);
+        }
+      } else {
+        finish_order.push_back(vertex);
+        stack.pop_back();
       }
     }
+  }
+
+  void ExtractSCC(T start, int index, std::vector<int>& component_index, std::vector<T>& scc) {
+    component_index[start] = index;
+    scc.emplace_back(start);
 
-    finish_order.push(vertex);
+    // scc doubles as the work list: members are expanded in discovery order
+    for (size_t next = 0; next < scc.size(); ++next) {
+      for (T neighbor : reverse_adjacency_list[scc[next]]) {
+        if (component_index[neighbor] == -1) {
+          component_index[neighbor] = index;
+          scc.emplace_back(neighbor);
+        }
+      }
+    }
   }
+};
 
-  void ExtractSCC(T vertex, std::vector<bool>& visited, std::vector<T>& scc) {
-    visited[vertex] = true;
-    scc.emplace_back(vertex);
+// Maintains the SCCs of a growing graph and the number of source and sink
+// components of its condensation, so "how many edges make the graph
+// strongly connected" can be answered after every insertion.
+//
+// Components are union-find sets; the condensation keeps deduplicated
+// in/out neighbor sets per representative and a topological position (the
+// Pearce-Kelly order). An edge that agrees with the order is just linked.
+// Otherwise only the affected window is searched: components reachable from
+// the head and reaching the tail. Those in both sets close a cycle with the
+// new edge and are merged, and the rest of the window is reordered around
+// them.
+template <typename T>
+class IncrementalCondensation {
+ public:
+  explicit IncrementalCondensation(int vertices)
+      : parent(vertices),
+        position(vertices),
+        out_edges(vertices),
+        in_edges(vertices),
+        stamp(vertices, 0),
+        component_count(vertices),
+        zero_in_count(vertices),
+        zero_out_count(vertices) {
+    for (T v = 0; v < vertices; ++v) {
+      parent[v] = v;
+      position[v] = v;
+    }
+  }
 
-    for (T neighbor : reverse_adjacency_list[vertex]) {
-      if (!visited[neighbor]) {
-        ExtractSCC(neighbor, visited, scc);
+  void AddEdge(T source, T destination) {
+    T from = Find(source);
+    T to = Find(destination);
+    if (from == to || out_edges[from].count(to) != 0) return;
+
+    int lower_bound = position[to];
+    int upper_bound = position[from];
+    if (lower_bound > upper_bound) {
+      Link(from, to);
+      return;
+    }
+
+    int forward_stamp = ++current_stamp;
+    Search(to, out_edges, forward, forward_stamp, [&](T c) { return position[c] <= upper_bound; });
+    int backward_stamp = ++current_stamp;
+    Search(from, in_edges, backward, backward_stamp, [&](T c) { return position[c] >= lower_bound; });
+
+    // Components in both searches lie on a cycle through the new edge
+    cycle.clear();
+    for (T c : forward) {
+      if (stamp[c] == backward_stamp) cycle.push_back(c);
+    }
+
+    if (cycle.empty()) {
+      Reorder(kNoComponent, 0);
+      Link(from, to);
+      return;
+    }
+
+    int merged_stamp = ++current_stamp;
+    for (T c : cycle) stamp[c] = merged_stamp;
+    T merged = Merge(merged_stamp);
+    Reorder(merged, merged_stamp);
+  }
+
+  int ComponentCount() const { return component_count; }
+
+  // Edges that must be added to make the graph strongly connected
+  int EdgesNeededToConnect() const {
+    return component_count <= 1 ? 0 : std::max(zero_in_count, zero_out_count);
+  }
+
+ private:
+  static constexpr T kNoComponent = -1;
+
+  std::vector<T> parent;
+  std::vector<int> position;
+  std::vector<std::unordered_set<T>> out_edges;
+  std::vector<std::unordered_set<T>> in_edges;
+  std::vector<int> stamp;
+  int current_stamp = 0;
+  int component_count;
+  int zero_in_count;
+  int zero_out_count;
+  std::vector<T> forward;
+  std::vector<T> backward;
+  std::vector<T> cycle;
+  std::vector<T> stack;
+  std::vector<int> slots;
+
+  T Find(T v) {
+    T root = v;
+    while (parent[root] != root) root = parent[root];
+    while (parent[v] != root) {
+      T next = parent[v];
+      parent[v] = root;
+      v = next;
+    }
+    return root;
+  }
+
+  void Link(T from, T to) {
+    zero_out_count -= out_edges[from].empty();
+    zero_in_count -= in_edges[to].empty();
+    out_edges[from].insert(to);
+    in_edges[to].insert(from);
+  }
+
+  template <typename InWindow>
+  void Search(T start, const std::vector<std::unordered_set<T>>& edges, std::vector<T>& reached, int search_stamp,
+              InWindow in_window) {
+    reached.clear();
+    stack.assign(1, start);
+    stamp[start] = search_stamp;
+    while (!stack.empty()) {
+      T current = stack.back();
+      stack.pop_back();
+      reached.push_back(current);
+      for (T next : edges[current]) {
+        if (stamp[next] != search_stamp && in_window(next)) {
+          stamp[next] = search_stamp;
+          stack.push_back(next);
+        }
       }
     }
   }
 
-  int GetComponentIndex(const std::vector<std::vector<T>>& scc_list, T vertex) const {
-    for (size_t i = 0; i < scc_list.size(); ++i) {
-      if (std::find(scc_list[i].begin(), scc_list[i].end(), vertex) != scc_list[i].end()) {
-        return static_cast<int>(i);
+  // Collapses the components stamped with merged_stamp into the one with
+  // the most condensation edges, rewiring the others' neighbors to it
+  T Merge(int merged_stamp) {
+    T merged = cycle.front();
+    for (T c : cycle) {
+      if (out_edges[c].size() + in_edges[c].size() > out_edges[merged].size() + in_edges[merged].size()) {
+        merged = c;
       }
     }
-    return -1;
+
+    for (T c : cycle) {
+      zero_out_count -= out_edges[c].empty();
+      zero_in_count -= in_edges[c].empty();
+    }
+    component_count -= static_cast<int>(cycle.size()) - 1;
+
+    for (T c : cycle) {
+      if (c == merged) continue;
+      parent[c] = merged;
+      out_edges[merged].erase(c);
+      in_edges[merged].erase(c);
+
+      for (T next : out_edges[c]) {
+        if (stamp[next] == merged_stamp) continue;
+        in_edges[next].erase(c);
+        in_edges[next].insert(merged);
+        out_edges[merged].insert(next);
+      }
+      for (T previous : in_edges[c]) {
+        if (stamp[previous] == merged_stamp) continue;
+        out_edges[previous].erase(c);
+        out_edges[previous].insert(merged);
+        in_edges[merged].insert(previous);
+      }
+      std::unordered_set<T>().swap(out_edges[c]);
+      std::unordered_set<T>().swap(in_edges[c]);
+    }
+
+    zero_out_count += out_edges[merged].empty();
+    zero_in_count += in_edges[merged].empty();
+    return merged;
+  }
+
+  // Reassigns the freed positions of the backward and forward sets
+  // (Pearce-Kelly). The backward set takes the lowest ones in old order,
+  // so none of its components moves up; the merged component (if any)
+  // comes right after it; the forward set takes the highest ones, so none
+  // of its components moves down. Components outside both sets keep their
+  // positions, and their edges into or out of the sets stay consistent.
+  void Reorder(T merged, int merged_stamp) {
+    auto by_position = [&](T a, T b) { return position[a] < position[b]; };
+    auto keeps_position = [&](T c) { return merged == kNoComponent || stamp[c] != merged_stamp; };
+
+    slots.clear();
+    for (T c : backward) slots.push_back(position[c]);
+    for (T c : forward) slots.push_back(position[c]);
+    std::sort(slots.begin(), slots.end());
+    slots.erase(std::unique(slots.begin(), slots.end()), slots.end());
+
+    std::vector<T> before;
+    std::vector<T> after;
+    for (T c : backward) {
+      if (keeps_position(c)) before.push_back(c);
+    }
+    for (T c : forward) {
+      if (keeps_position(c)) after.push_back(c);
+    }
+    std::sort(before.begin(), before.end(), by_position);
+    std::sort(after.begin(), after.end(), by_position);
+
+    for (size_t i = 0; i < before.size(); ++i) position[before[i]] = slots[i];
+    if (merged != kNoComponent) position[merged] = slots[before.size()];
+    size_t first_after = slots.size() - after.size();
+    for (size_t i = 0; i < after.size(); ++i) position[after[i]] = slots[first_after + i];
   }
 };
 
-int main() {
+// Edges needed to make the graph strongly connected, from scratch
+int EdgesNeededByRebuild(int vertices, const std::vector<std::pair<int, int>>& edges) {
+  Graph<int> graph(vertices);
+  for (const auto& edge : edges) graph.AddEdge(edge.first, edge.second);
+  std::vector<int> component_index;
+  auto sccs = graph.FindStronglyConnectedComponents(component_index);
+  if (sccs.size() <= 1) return 0;
+  auto degrees = graph.CondenseGraph(sccs, component_index).CalculateDegrees();
+  return std::max(degrees.first, degrees.second);
+}
+
+// Replays `sequences` random insertion sequences on small graphs and
+// compares IncrementalCondensation with a full rebuild after every edge.
+// Reports the first mismatch on stderr; false if there is one.
+bool CheckIncremental(int sequences) {
+  std::mt19937 random(1);
+  int steps = 0;
+  for (int sequence = 0; sequence < sequences; ++sequence) {
+    int vertices = std::uniform_int_distribution<int>(1, 12)(random);
+    int edge_count = std::uniform_int_distribution<int>(0, 3 * vertices)(random);
+    std::uniform_int_distribution<int> pick(0, vertices - 1);
+
+    IncrementalCondensation<int> condensation(vertices);
+    std::vector<std::pair<int, int>> edges;
+    for (int i = 0; i < edge_count; ++i, ++steps) {
+      edges.emplace_back(pick(random), pick(random));
+      condensation.AddEdge(edges.back().first, edges.back().second);
+      int expected = EdgesNeededByRebuild(vertices, edges);
+      if (condensation.EdgesNeededToConnect() != expected) {
+        std::cerr << "incremental check: MISMATCH after " << edges.size() << " edges on " << vertices
+                  << " vertices: " << condensation.EdgesNeededToConnect() << ", rebuild " << expected << "\n";
+        for (const auto& edge : edges) std::cerr << "  " << edge.first + 1 << " " << edge.second + 1 << "\n";
+        return false;
+      }
+    }
+  }
+  std::cerr << "incremental check: " << sequences << " sequences, " << steps << " insertions, ok\n";
+  return true;
+}
+
+int main(int argc, char* argv[]) {
+  bool parallel = false;
+  bool incremental = false;
+  int check_sequences = 0;
+  int threads = 0;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--parallel") {
+      parallel = true;
+    } else if (arg == "--threads" && i + 1 < argc) {
+      threads = std::stoi(argv[++i]);
+    } else if (arg == "--incremental") {
+      incremental = true;
+    } else if (arg == "--check-incremental" && i + 1 < argc) {
+      check_sequences = std::stoi(argv[++i]);
+    }
+  }
+  if (check_sequences > 0) return CheckIncremental(check_sequences) ? 0 : 1;
+  if (threads <= 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  std::ios::sync_with_stdio(false);
+  std::cin.tie(nullptr);
+
   int vertices, edges;
   std::cin >> vertices >> edges;
 
+  if (incremental) {
+    // Answer the query after every inserted edge, one line each
+    IncrementalCondensation<int> condensation(vertices);
+    for (int i = 0; i < edges; ++i) {
+      int from, to;
+      std::cin >> from >> to;
+      condensation.AddEdge(from - 1, to - 1);
+      std::cout << condensation.EdgesNeededToConnect() << "\n";
+    }
+    return 0;
+  }
+
   Graph<int> city_graph(vertices);
 
   for (int i = 0; i < edges; ++i) {
@@ -134,7 +622,9 @@ int main() {
   }
 
   // Find all strongly connected components (SCCs)
-  auto sccs = city_graph.FindStronglyConnectedComponents();
+  std::vector<int> component_index;
+  auto sccs = parallel ? city_graph.FindStronglyConnectedComponentsParallel(component_index, threads)
+                       : city_graph.FindStronglyConnectedComponents(component_index);
 
   // If there's only one SCC or no edges in the graph
   if (sccs.size() <= 1) {
@@ -143,10 +633,10 @@ int main() {
   }
 
   // Create the condensed graph
-  Graph<int> condensed_graph = city_graph.CondenseGraph(sccs);
+  Graph<int> condensed_graph = city_graph.CondenseGraph(sccs, component_index);
 
   // Calculate the in-degrees and out-degrees for the condensed graph
-  auto degrees = condensed_graph.CalculateDegrees();
+  auto degrees = parallel ? condensed_graph.CalculateDegrees(threads) : condensed_graph.CalculateDegrees();
 
   // Output the maximum of zero in-degrees or zero out-degrees
   std::cout << std::max(degrees.first, degrees.second) << std::endl;
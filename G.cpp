@@ -1,15 +1,159 @@
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <iostream>
+#include <limits>
 #include <queue>
+#include <string>
+#include <utility>
 #include <vector>
 
 // Define a large constant to represent "infinity"
 const int kMax = 1e8;
 
+// Largest edge weight for which Dial's bucket queue is used; above it the
+// ring of buckets gets sparse and the radix heap wins
+const uint64_t kMaxBucketWeight = 1 << 12;
+
+// Distance of a vertex that cannot be reached at all, used by the uncapped
+// landmark searches
+const uint64_t kUnreachable = std::numeric_limits<uint64_t>::max();
+
+// Number of ALT landmarks unless `--landmarks N` is given
+const size_t kDefaultLandmarks = 4;
+
+// How `main` answers the query
+enum class SearchMode {
+    kFullSearch,    // single-source search over every universe
+    kBidirectional, // bidirectional Dijkstra, stops when the frontiers meet
+    kAlt,           // A* with landmark lower bounds
+};
+
+// Queue used by `MinBottlesLemonade`
+enum class QueuePolicy {
+    kFifo,      // label-correcting FIFO queue, a vertex may be expanded many times
+    kRadixHeap, // monotone radix heap, every vertex is settled once
+    kBuckets,   // Dial's circular buckets, every vertex is settled once
+    kAuto,      // buckets when the largest weight is small, radix heap otherwise
+};
+
+// Monotone min-priority queue over 64-bit keys. Every pushed key must be at
+// least the last popped key, which holds for Dijkstra with non-negative
+// weights. Bucket `i` holds keys whose highest bit differing from the last
+// popped key is bit `i - 1`, so each entry moves down at most 64 times.
+template <typename Value>
+class RadixHeap {
+private:
+    std::vector<std::pair<uint64_t, Value>> buckets_[65];
+    uint64_t last_ = 0; // Last popped key
+    size_t size_ = 0;
+
+    size_t BucketOf(uint64_t key) const {
+        return key == last_ ? 0 : 64 - __builtin_clzll(key ^ last_);
+    }
+
+public:
+    bool Empty() const {
+        return size_ == 0;
+    }
+
+    void Push(uint64_t key, Value value) {
+        buckets_[BucketOf(key)].emplace_back(key, value);
+        ++size_;
+    }
+
+    // Returns the smallest key without removing it; the heap must not be empty
+    uint64_t MinKey() {
+        if (buckets_[0].empty()) {
+            size_t i = 1;
+            while (buckets_[i].empty()) {
+                ++i;
+            }
+            last_ = buckets_[i][0].first;
+            for (const auto& entry : buckets_[i]) {
+                last_ = std::min(last_, entry.first);
+            }
+            for (const auto& entry : buckets_[i]) {
+                buckets_[BucketOf(entry.first)].push_back(entry);
+            }
+            buckets_[i].clear();
+        }
+        return last_;
+    }
+
+    // Removes and returns an entry with the smallest key
+    std::pair<uint64_t, Value> Pop() {
+        MinKey();
+        std::pair<uint64_t, Value> top = buckets_[0].back();
+        buckets_[0].pop_back();
+        --size_;
+        return top;
+    }
+};
+
+// Dial's bucket queue: a ring of `max_weight + 1` buckets indexed by key.
+// Pushed keys must lie in [last popped key, last popped key + max_weight].
+template <typename Value>
+class BucketQueue {
+private:
+    std::vector<std::vector<Value>> buckets_;
+    uint64_t cursor_ = 0; // Key of the bucket at `slot_`
+    size_t slot_ = 0;
+    size_t size_ = 0;
+
+public:
+    explicit BucketQueue(uint64_t max_weight) : buckets_(max_weight + 1) {}
+
+    bool Empty() const {
+        return size_ == 0;
+    }
+
+    void Push(uint64_t key, Value value) {
+        size_t slot = slot_ + (key - cursor_);
+        if (slot >= buckets_.size()) {
+            slot -= buckets_.size();
+        }
+        buckets_[slot].push_back(value);
+        ++size_;
+    }
+
+    // Returns the smallest key without removing it; the queue must not be empty
+    uint64_t MinKey() {
+        while (buckets_[slot_].empty()) {
+            ++cursor_;
+            if (++slot_ == buckets_.size()) {
+                slot_ = 0;
+            }
+        }
+        return cursor_;
+    }
+
+    // Removes and returns an entry with the smallest key
+    std::pair<uint64_t, Value> Pop() {
+        MinKey();
+        Value value = buckets_[slot_].back();
+        buckets_[slot_].pop_back();
+        --size_;
+        return {cursor_, value};
+    }
+};
+
+// Shortest path routines below are templated on a neighbor generator: any
+// type that provides
+//
+//     uint64_t GetNumVertices() const;
+//     uint64_t GetMaxWeight() const;
+//     template <typename Visitor>
+//     void ForEachNeighbor(uint64_t u, Visitor&& visit) const;
+//
+// where `visit(v, weight)` is called once for every edge u -> v. `Graph`
+// stores its edges explicitly; `LemonadeGraph` derives them on the fly.
+
 // Class representing a directed graph
 class Graph {
 private:
     uint64_t num_vertices_; // Number of vertices in the graph
+    uint64_t max_weight_ = 0; // Largest edge weight added so far
     std::vector<std::vector<std::pair<uint64_t, uint64_t>>> adj_list_; // Adjacency list
 
 public:
@@ -20,6 +164,7 @@ public:
     // Adds a directed edge from vertex `u` to vertex `v` with the given weight
     void AddEdge(uint64_t u, uint64_t v, uint64_t weight) {
         adj_list_[u].emplace_back(v, weight);
+        max_weight_ = std::max(max_weight_, weight);
     }
 
     // Returns the adjacency list of the graph
@@ -31,18 +176,123 @@ public:
     uint64_t GetNumVertices() const {
         return num_vertices_;
     }
+
+    // Returns the largest edge weight in the graph
+    uint64_t GetMaxWeight() const {
+        return max_weight_;
+    }
+
+    // Calls `visit(v, weight)` for every edge leaving vertex `u`
+    template <typename Visitor>
+    void ForEachNeighbor(uint64_t u, Visitor&& visit) const {
+        for (const auto& edge : adj_list_[u]) {
+            visit(edge.first, edge.second);
+        }
+    }
+};
+
+// Implicit lemonade graph: universe `i` has an edge to `(i + 1) % m` with
+// cost `a` and an edge to `(i * i + 1) % m` with cost `b`. Nothing is stored
+// beyond the three parameters, so the only O(m) memory a query needs is its
+// own distance array.
+class LemonadeGraph {
+private:
+    uint64_t step_cost_;   // Cost of the `i + 1` edge
+    uint64_t square_cost_; // Cost of the `i * i + 1` edge
+    uint64_t num_vertices_;
+
+public:
+    LemonadeGraph(uint64_t step_cost, uint64_t square_cost, uint64_t vertices)
+        : step_cost_(step_cost), square_cost_(square_cost), num_vertices_(vertices) {}
+
+    uint64_t GetNumVertices() const {
+        return num_vertices_;
+    }
+
+    uint64_t GetMaxWeight() const {
+        return std::max(step_cost_, square_cost_);
+    }
+
+    uint64_t GetStepCost() const {
+        return step_cost_;
+    }
+
+    uint64_t GetSquareCost() const {
+        return square_cost_;
+    }
+
+    // Calls `visit(v, weight)` for both edges leaving universe `u`
+    template <typename Visitor>
+    void ForEachNeighbor(uint64_t u, Visitor&& visit) const {
+        visit((u + 1) % num_vertices_, step_cost_);
+        visit((u * u + 1) % num_vertices_, square_cost_);
+    }
+
+    // Materializes the same edges as an explicit `Graph`
+    Graph ToGraph() const {
+        Graph graph(num_vertices_);
+        for (uint64_t i = 0; i < num_vertices_; ++i) {
+            ForEachNeighbor(i, [&](uint64_t v, uint64_t weight) {
+                graph.AddEdge(i, v, weight);
+            });
+        }
+        return graph;
+    }
 };
 
-// Function to calculate the minimum bottles of lemonade needed to travel
-// from universe `x` to universe `y`
-uint64_t MinBottlesLemonade(const Graph& graph, uint64_t x, uint64_t y) {
-    uint64_t num_vertices = graph.GetNumVertices();
+// Reverse of `LemonadeGraph`, a neighbor generator over incoming edges. The
+// `i + 1` predecessor is computed; the `i * i + 1` predecessors have no cheap
+// closed form modulo `m`, so they are bucketed once into a CSR of 2m words.
+class ReverseLemonadeGraph {
+private:
+    uint64_t step_cost_;
+    uint64_t square_cost_;
+    uint64_t num_vertices_;
+    std::vector<uint64_t> offsets_; // Square predecessors of `v` are sources_[offsets_[v], offsets_[v + 1])
+    std::vector<uint64_t> sources_;
 
-    // If the source and destination are the same, no bottles are needed
-    if (x == y) {
-        return 0;
+public:
+    explicit ReverseLemonadeGraph(const LemonadeGraph& graph)
+        : step_cost_(graph.GetStepCost()), square_cost_(graph.GetSquareCost()),
+          num_vertices_(graph.GetNumVertices()),
+          offsets_(num_vertices_ + 1, 0), sources_(num_vertices_) {
+        uint64_t m = num_vertices_;
+        for (uint64_t i = 0; i < m; ++i) {
+            ++offsets_[(i * i + 1) % m + 1];
+        }
+        for (uint64_t v = 0; v < m; ++v) {
+            offsets_[v + 1] += offsets_[v];
+        }
+        std::vector<uint64_t> cursor(offsets_.begin(), offsets_.end() - 1);
+        for (uint64_t i = 0; i < m; ++i) {
+            sources_[cursor[(i * i + 1) % m]++] = i;
+        }
+    }
+
+    uint64_t GetNumVertices() const {
+        return num_vertices_;
+    }
+
+    uint64_t GetMaxWeight() const {
+        return std::max(step_cost_, square_cost_);
     }
 
+    // Calls `visit(u, weight)` for every edge u -> `v`
+    template <typename Visitor>
+    void ForEachNeighbor(uint64_t v, Visitor&& visit) const {
+        visit((v + num_vertices_ - 1) % num_vertices_, step_cost_);
+        for (uint64_t i = offsets_[v]; i < offsets_[v + 1]; ++i) {
+            visit(sources_[i], square_cost_);
+        }
+    }
+};
+
+// Label-correcting search from universe `x`: a FIFO queue with repeated
+// relaxations. Returns the minimum bottles needed to reach every universe.
+template <typename GraphType>
+std::vector<uint64_t> MinBottlesFifo(const GraphType& graph, uint64_t x) {
+    uint64_t num_vertices = graph.GetNumVertices();
+
     // Initialize the minimum bottles array with a large value
     std::vector<uint64_t> min_bottles(num_vertices, kMax);
     min_bottles[x] = 0;
@@ -57,23 +307,338 @@ uint64_t MinBottlesLemonade(const Graph& graph, uint64_t x, uint64_t y) {
         queue.pop();
 
         // Explore all adjacent vertices
-        for (const auto& edge : graph.GetAdjList()[current_vertex]) {
-            uint64_t next_vertex = edge.first;
-            uint64_t weight = edge.second;
-
+        graph.ForEachNeighbor(current_vertex, [&](uint64_t next_vertex, uint64_t weight) {
             // Relaxation step: update the minimum bottles if a better path is found
             if (min_bottles[next_vertex] > min_bottles[current_vertex] + weight) {
                 min_bottles[next_vertex] = min_bottles[current_vertex] + weight;
                 queue.push(next_vertex);
             }
+        });
+    }
+
+    return min_bottles;
+}
+
+// Dijkstra from universe `x` on a monotone queue. A vertex is expanded only
+// when popped with its final distance, so each one is settled once; entries
+// left behind by later improvements are skipped as stale. Distances of
+// `limit` or more are reported as `limit`.
+template <typename GraphType, typename Queue>
+std::vector<uint64_t> MinBottlesDijkstra(const GraphType& graph, uint64_t x, Queue queue,
+                                         uint64_t limit = kMax, uint64_t* settled = nullptr) {
+    std::vector<uint64_t> min_bottles(graph.GetNumVertices(), limit);
+    min_bottles[x] = 0;
+    queue.Push(0, x);
+
+    while (!queue.Empty()) {
+        std::pair<uint64_t, uint64_t> top = queue.Pop();
+        uint64_t bottles = top.first;
+        uint64_t current_vertex = top.second;
+        if (bottles > min_bottles[current_vertex]) {
+            continue;
+        }
+        if (settled != nullptr) {
+            ++*settled;
+        }
+
+        graph.ForEachNeighbor(current_vertex, [&](uint64_t next_vertex, uint64_t weight) {
+            if (min_bottles[next_vertex] > bottles + weight) {
+                min_bottles[next_vertex] = bottles + weight;
+                queue.Push(bottles + weight, next_vertex);
+            }
+        });
+    }
+
+    return min_bottles;
+}
+
+// Function to calculate the minimum bottles of lemonade needed to travel
+// from universe `x` to universe `y`. `GraphType` is any neighbor generator.
+template <typename GraphType>
+uint64_t MinBottlesLemonade(const GraphType& graph, uint64_t x, uint64_t y,
+                            QueuePolicy policy = QueuePolicy::kAuto) {
+    // If the source and destination are the same, no bottles are needed
+    if (x == y) {
+        return 0;
+    }
+
+    if (policy == QueuePolicy::kAuto) {
+        policy = graph.GetMaxWeight() <= kMaxBucketWeight ? QueuePolicy::kBuckets
+                                                          : QueuePolicy::kRadixHeap;
+    }
+    switch (policy) {
+        case QueuePolicy::kFifo:
+            return MinBottlesFifo(graph, x)[y];
+        case QueuePolicy::kBuckets:
+            return MinBottlesDijkstra(graph, x, BucketQueue<uint64_t>(graph.GetMaxWeight()))[y];
+        default:
+            return MinBottlesDijkstra(graph, x, RadixHeap<uint64_t>())[y];
+    }
+}
+
+// Times every queue policy on the same query and reports to stderr
+template <typename GraphType>
+void BenchmarkQueues(const GraphType& graph, uint64_t x, uint64_t y) {
+    using Clock = std::chrono::steady_clock;
+    const std::pair<QueuePolicy, const char*> policies[] = {
+        {QueuePolicy::kFifo, "fifo"},
+        {QueuePolicy::kRadixHeap, "radix heap"},
+        {QueuePolicy::kBuckets, "buckets"},
+    };
+
+    uint64_t reference = 0;
+    for (const auto& policy : policies) {
+        auto start = Clock::now();
+        uint64_t result = MinBottlesLemonade(graph, x, y, policy.first);
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        if (policy.first == QueuePolicy::kFifo) {
+            reference = result;
+        }
+        std::cerr << policy.second << ": " << seconds << " s"
+                  << (result == reference ? "" : " (MISMATCH)") << "\n";
+    }
+}
+
+// Point-to-point search from `x` to `y`. Bidirectional Dijkstra grows a
+// forward search over `graph` and a backward one over `reverse`, always
+// expanding the side with the smaller key. `best` is the shortest x -> y
+// path seen through any scanned edge; once the two smallest keys add up to
+// `best`, no unexplored path can be shorter. Same `kMax` cap as the full
+// search.
+template <typename GraphType, typename ReverseType>
+uint64_t BidirectionalMinBottles(const GraphType& graph, const ReverseType& reverse,
+                                 uint64_t x, uint64_t y, uint64_t* settled = nullptr) {
+    if (x == y) {
+        return 0;
+    }
+
+    uint64_t num_vertices = graph.GetNumVertices();
+    std::vector<uint64_t> min_bottles[2] = {std::vector<uint64_t>(num_vertices, kMax),
+                                            std::vector<uint64_t>(num_vertices, kMax)};
+    RadixHeap<uint64_t> queues[2];
+    min_bottles[0][x] = 0;
+    min_bottles[1][y] = 0;
+    queues[0].Push(0, x);
+    queues[1].Push(0, y);
+
+    uint64_t best = kMax;
+    while (!queues[0].Empty() && !queues[1].Empty()) {
+        uint64_t forward_key = queues[0].MinKey();
+        uint64_t backward_key = queues[1].MinKey();
+        if (forward_key + backward_key >= best) {
+            break;
+        }
+
+        int side = forward_key <= backward_key ? 0 : 1;
+        std::vector<uint64_t>& own = min_bottles[side];
+        const std::vector<uint64_t>& other = min_bottles[1 - side];
+        std::pair<uint64_t, uint64_t> top = queues[side].Pop();
+        uint64_t bottles = top.first;
+        uint64_t current_vertex = top.second;
+        if (bottles > own[current_vertex]) {
+            continue;
+        }
+        if (settled != nullptr) {
+            ++*settled;
+        }
+
+        auto relax = [&](uint64_t next_vertex, uint64_t weight) {
+            if (own[next_vertex] > bottles + weight) {
+                own[next_vertex] = bottles + weight;
+                queues[side].Push(bottles + weight, next_vertex);
+            }
+            best = std::min(best, own[next_vertex] + other[next_vertex]);
+        };
+        if (side == 0) {
+            graph.ForEachNeighbor(current_vertex, relax);
+        } else {
+            reverse.ForEachNeighbor(current_vertex, relax);
+        }
+    }
+
+    return best;
+}
+
+// ALT heuristic: exact distances from and to a few landmarks give, by the
+// triangle inequality, a consistent lower bound on the distance between any
+// two vertices. Landmarks are picked farthest-first, starting from the
+// vertex farthest from universe 0.
+class Landmarks {
+private:
+    std::vector<std::vector<uint64_t>> from_; // from_[l][v]: distance from landmark `l` to `v`
+    std::vector<std::vector<uint64_t>> to_;   // to_[l][v]: distance from `v` to landmark `l`
+
+public:
+    template <typename GraphType, typename ReverseType>
+    Landmarks(const GraphType& graph, const ReverseType& reverse, size_t count) {
+        uint64_t num_vertices = graph.GetNumVertices();
+        std::vector<uint64_t> nearest =
+            MinBottlesDijkstra(graph, 0, RadixHeap<uint64_t>(), kUnreachable);
+
+        for (size_t l = 0; l < count; ++l) {
+            uint64_t landmark = 0;
+            uint64_t farthest = 0;
+            for (uint64_t v = 0; v < num_vertices; ++v) {
+                if (nearest[v] != kUnreachable && nearest[v] > farthest) {
+                    landmark = v;
+                    farthest = nearest[v];
+                }
+            }
+            if (l > 0 && farthest == 0) {
+                break;
+            }
+
+            from_.push_back(MinBottlesDijkstra(graph, landmark, RadixHeap<uint64_t>(), kUnreachable));
+            to_.push_back(MinBottlesDijkstra(reverse, landmark, RadixHeap<uint64_t>(), kUnreachable));
+            for (uint64_t v = 0; v < num_vertices; ++v) {
+                nearest[v] = l == 0 ? from_[l][v] : std::min(nearest[v], from_[l][v]);
+            }
         }
     }
 
-    // Return the minimum bottles required to reach universe `y`
+    size_t GetCount() const {
+        return from_.size();
+    }
+
+    // Lower bound on the distance from `v` to `target`, or `kUnreachable`
+    // when some landmark proves `target` cannot be reached from `v`
+    uint64_t LowerBound(uint64_t v, uint64_t target) const {
+        uint64_t bound = 0;
+        for (size_t l = 0; l < from_.size(); ++l) {
+            const std::vector<uint64_t>& from = from_[l];
+            const std::vector<uint64_t>& to = to_[l];
+
+            // d(l, target) <= d(l, v) + d(v, target)
+            if (from[v] != kUnreachable) {
+                if (from[target] == kUnreachable) {
+                    return kUnreachable;
+                }
+                if (from[target] > from[v]) {
+                    bound = std::max(bound, from[target] - from[v]);
+                }
+            }
+            // d(v, l) <= d(v, target) + d(target, l)
+            if (to[target] != kUnreachable) {
+                if (to[v] == kUnreachable) {
+                    return kUnreachable;
+                }
+                if (to[v] > to[target]) {
+                    bound = std::max(bound, to[v] - to[target]);
+                }
+            }
+        }
+        return bound;
+    }
+};
+
+// A* from `x` to `y` guided by `landmarks`. The heuristic is consistent, so
+// keys never decrease, the radix heap applies, and a vertex is final when
+// first popped. Same `kMax` cap as the full search.
+template <typename GraphType>
+uint64_t AltMinBottles(const GraphType& graph, const Landmarks& landmarks,
+                       uint64_t x, uint64_t y, uint64_t* settled = nullptr) {
+    if (x == y) {
+        return 0;
+    }
+    uint64_t start_bound = landmarks.LowerBound(x, y);
+    if (start_bound == kUnreachable) {
+        return kMax;
+    }
+
+    std::vector<uint64_t> min_bottles(graph.GetNumVertices(), kMax);
+    std::vector<char> closed(graph.GetNumVertices(), 0);
+    RadixHeap<uint64_t> queue;
+    min_bottles[x] = 0;
+    queue.Push(start_bound, x);
+
+    while (!queue.Empty()) {
+        uint64_t current_vertex = queue.Pop().second;
+        if (closed[current_vertex]) {
+            continue;
+        }
+        closed[current_vertex] = 1;
+        if (settled != nullptr) {
+            ++*settled;
+        }
+        if (current_vertex == y) {
+            break;
+        }
+
+        uint64_t bottles = min_bottles[current_vertex];
+        graph.ForEachNeighbor(current_vertex, [&](uint64_t next_vertex, uint64_t weight) {
+            if (closed[next_vertex] || min_bottles[next_vertex] <= bottles + weight) {
+                return;
+            }
+            uint64_t bound = landmarks.LowerBound(next_vertex, y);
+            if (bound != kUnreachable) {
+                min_bottles[next_vertex] = bottles + weight;
+                queue.Push(bottles + weight + bound, next_vertex);
+            }
+        });
+    }
+
     return min_bottles[y];
 }
 
-int main() {
+// Times full single-source search, bidirectional search and ALT on the same
+// query and reports settled-vertex counts to stderr
+void BenchmarkPointToPoint(const LemonadeGraph& graph, uint64_t x, uint64_t y, size_t landmark_count) {
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    auto elapsed = [&]() {
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        start = Clock::now();
+        return seconds;
+    };
+
+    uint64_t full_settled = 0;
+    uint64_t reference = MinBottlesDijkstra(graph, x, RadixHeap<uint64_t>(), kMax, &full_settled)[y];
+    std::cerr << "full search: " << elapsed() << " s, settled " << full_settled << "\n";
+
+    ReverseLemonadeGraph reverse(graph);
+    std::cerr << "reverse graph: " << elapsed() << " s\n";
+    uint64_t settled = 0;
+    uint64_t result = x == y ? 0 : BidirectionalMinBottles(graph, reverse, x, y, &settled);
+    std::cerr << "bidirectional: " << elapsed() << " s, settled " << settled
+              << (result == (x == y ? 0 : reference) ? "" : " (MISMATCH)") << "\n";
+
+    Landmarks landmarks(graph, reverse, landmark_count);
+    std::cerr << landmarks.GetCount() << " landmarks: " << elapsed() << " s\n";
+    settled = 0;
+    result = AltMinBottles(graph, landmarks, x, y, &settled);
+    std::cerr << "alt: " << elapsed() << " s, settled " << settled
+              << (result == (x == y ? 0 : reference) ? "" : " (MISMATCH)") << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    // `--explicit` builds the adjacency lists instead of generating edges
+    bool use_explicit = false;
+    bool bench = false;
+    QueuePolicy policy = QueuePolicy::kAuto;
+    SearchMode mode = SearchMode::kFullSearch;
+    size_t landmark_count = kDefaultLandmarks;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--explicit") {
+            use_explicit = true;
+        } else if (arg == "--fifo") {
+            policy = QueuePolicy::kFifo;
+        } else if (arg == "--radix-heap") {
+            policy = QueuePolicy::kRadixHeap;
+        } else if (arg == "--buckets") {
+            policy = QueuePolicy::kBuckets;
+        } else if (arg == "--bidirectional") {
+            mode = SearchMode::kBidirectional;
+        } else if (arg == "--alt") {
+            mode = SearchMode::kAlt;
+        } else if (arg == "--landmarks" && i + 1 < argc) {
+            landmark_count = std::stoul(argv[++i]);
+        } else if (arg == "--bench") {
+            bench = true;
+        }
+    }
+
     uint64_t a; // Cost of the first type of edge
     uint64_t b; // Cost of the second type of edge
     uint64_t m; // Number of universes
@@ -83,17 +648,29 @@ int main() {
     // Input the parameters
     std::cin >> a >> b >> m >> x >> y;
 
-    // Initialize the graph with `m` universes
-    Graph graph(m);
-
-    // Add edges to the graph
-    for (uint64_t i = 0; i < m; ++i) {
-        graph.AddEdge(i, (i + 1) % m, a);         // First type of edge
-        graph.AddEdge(i, (i * i + 1) % m, b);     // Second type of edge
+    // The universes and their edges are generated from `a`, `b` and `m`
+    LemonadeGraph lemonade(a, b, m);
+    if (bench) {
+        BenchmarkQueues(lemonade, x, y);
+        BenchmarkPointToPoint(lemonade, x, y, landmark_count);
     }
 
     // Compute the minimum bottles required and output the result
-    uint64_t result = MinBottlesLemonade(graph, x, y);
+    uint64_t result;
+    if (mode == SearchMode::kFullSearch) {
+        result = use_explicit ? MinBottlesLemonade(lemonade.ToGraph(), x, y, policy)
+                              : MinBottlesLemonade(lemonade, x, y, policy);
+    } else {
+        ReverseLemonadeGraph reverse(lemonade);
+        uint64_t settled = 0;
+        if (mode == SearchMode::kBidirectional) {
+            result = BidirectionalMinBottles(lemonade, reverse, x, y, &settled);
+        } else {
+            Landmarks landmarks(lemonade, reverse, landmark_count);
+            result = AltMinBottles(lemonade, landmarks, x, y, &settled);
+        }
+        std::cerr << "settled " << settled << " of " << m << " universes\n";
+    }
     std::cout << result << std::endl;
 
     return 0;
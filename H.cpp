@@ -1,11 +1,175 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <iostream>
+#include <list>
+#include <mutex>
+#include <numeric>
 #include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <limits>
 
 // Define a constant representing a very large value
 const int kMax = 1e6;
 
+// Largest edge cost for which Dial's bucket queue is used; above it the
+// ring of buckets gets sparse and the radix heap wins
+const int kMaxBucketWeight = 1 << 12;
+
+// Largest (vertex, flights) distance table the state-space engine may
+// allocate; above it `Dijkstra` switches to the layered engine
+const size_t kMaxTableBytes = size_t(1) << 28;
+
+// `Dijkstra` also switches to the layered engine once (k + 1) * m, the
+// edges the state-space search may relax, exceeds this many layered
+// rounds of n + m work. The layered engine stops at the first round that
+// changes nothing, so on sparse graphs with many allowed flights it runs
+// far fewer than k rounds. The crossover was measured on random graphs:
+// below about 130 the state space won, above about 190 the layered
+// engine did.
+const double kLayeredRoundsCrossover = 160;
+
+// Default memory budget of the per-source table cache, in megabytes
+const size_t kDefaultCacheMegabytes = 256;
+
+// Default number of queries `--batch` hands to the service per call
+const size_t kDefaultWindow = 4096;
+
+// Algorithm used by `Dijkstra`
+enum class Engine {
+    kStateSpace, // Dijkstra over an n x (k + 1) table of (vertex, flights) states
+    kLayered,    // k rounds of Bellman-Ford over two rolling distance arrays
+    kAuto,       // layered when the state-space table or edge work is too large, see `Dijkstra`
+};
+
+// Queue used by the state-space engine
+enum class QueuePolicy {
+    kBinaryHeap, // std::priority_queue with stale entries, the only choice for negative costs
+    kRadixHeap,  // monotone radix heap, every (vertex, flights) state is settled once
+    kBuckets,    // Dial's circular buckets, every (vertex, flights) state is settled once
+    kAuto,       // buckets when the largest cost is small, radix heap otherwise
+};
+
+// Reusable barrier for threads that advance in lockstep rounds
+class RoundBarrier {
+private:
+    std::mutex mutex_;
+    std::condition_variable released_;
+    int threads_;
+    int arrived_ = 0;
+    uint64_t generation_ = 0;
+
+public:
+    explicit RoundBarrier(int threads) : threads_(threads) {}
+
+    void Wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        uint64_t generation = generation_;
+        if (++arrived_ == threads_) {
+            arrived_ = 0;
+            ++generation_;
+            released_.notify_all();
+        } else {
+            released_.wait(lock, [&] { return generation_ != generation; });
+        }
+    }
+};
+
+// Monotone min-priority queue over 64-bit keys. Every pushed key must be at
+// least the last popped key, which holds for Dijkstra with non-negative
+// weights. Bucket `i` holds keys whose highest bit differing from the last
+// popped key is bit `i - 1`, so each entry moves down at most 64 times.
+template <typename Value>
+class RadixHeap {
+private:
+    std::vector<std::pair<uint64_t, Value>> buckets_[65];
+    uint64_t last_ = 0; // Last popped key
+    size_t size_ = 0;
+
+    size_t BucketOf(uint64_t key) const {
+        return key == last_ ? 0 : 64 - __builtin_clzll(key ^ last_);
+    }
+
+public:
+    bool Empty() const {
+        return size_ == 0;
+    }
+
+    void Push(uint64_t key, Value value) {
+        buckets_[BucketOf(key)].emplace_back(key, value);
+        ++size_;
+    }
+
+    // Removes and returns an entry with the smallest key
+    std::pair<uint64_t, Value> Pop() {
+        if (buckets_[0].empty()) {
+            size_t i = 1;
+            while (buckets_[i].empty()) {
+                ++i;
+            }
+            last_ = buckets_[i][0].first;
+            for (const auto& entry : buckets_[i]) {
+                last_ = std::min(last_, entry.first);
+            }
+            for (const auto& entry : buckets_[i]) {
+                buckets_[BucketOf(entry.first)].push_back(entry);
+            }
+            buckets_[i].clear();
+        }
+        std::pair<uint64_t, Value> top = buckets_[0].back();
+        buckets_[0].pop_back();
+        --size_;
+        return top;
+    }
+};
+
+// Dial's bucket queue: a ring of `max_weight + 1` buckets indexed by key.
+// Pushed keys must lie in [last popped key, last popped key + max_weight].
+template <typename Value>
+class BucketQueue {
+private:
+    std::vector<std::vector<Value>> buckets_;
+    uint64_t cursor_ = 0; // Key of the bucket at `slot_`
+    size_t slot_ = 0;
+    size_t size_ = 0;
+
+public:
+    explicit BucketQueue(uint64_t max_weight) : buckets_(max_weight + 1) {}
+
+    bool Empty() const {
+        return size_ == 0;
+    }
+
+    void Push(uint64_t key, Value value) {
+        size_t slot = slot_ + (key - cursor_);
+        if (slot >= buckets_.size()) {
+            slot -= buckets_.size();
+        }
+        buckets_[slot].push_back(value);
+        ++size_;
+    }
+
+    // Removes and returns an entry with the smallest key
+    std::pair<uint64_t, Value> Pop() {
+        while (buckets_[slot_].empty()) {
+            ++cursor_;
+            if (++slot_ == buckets_.size()) {
+                slot_ = 0;
+            }
+        }
+        Value value = buckets_[slot_].back();
+        buckets_[slot_].pop_back();
+        --size_;
+        return {cursor_, value};
+    }
+};
+
+
 // Struct representing an edge in the graph
 struct Edge {
     int to;    // Destination vertex
@@ -16,6 +180,9 @@ struct Edge {
 class Graph {
 private:
     int num_vertices_; // Number of vertices in the graph
+    int min_cost_ = 0; // Smallest edge cost, or 0 when there are no negative costs
+    int max_cost_ = 0; // Largest edge cost
+    int64_t num_edges_ = 0; // Number of edges added
     std::vector<std::vector<Edge>> adj_list_; // Adjacency list representation
 
 public:
@@ -25,6 +192,9 @@ public:
     // Adds a directed edge to the graph
     void AddEdge(int from, int to, int cost) {
         adj_list_[from].push_back({to, cost});
+        ++num_edges_;
+        min_cost_ = std::min(min_cost_, cost);
+        max_cost_ = std::max(max_cost_, cost);
     }
 
     // Returns the adjacency list of the graph
@@ -36,10 +206,26 @@ public:
     int GetNumVertices() const {
         return num_vertices_;
     }
+
+    // Returns the number of edges in the graph
+    int64_t GetNumEdges() const {
+        return num_edges_;
+    }
+
+    // Returns the smallest edge cost, clamped to at most 0
+    int GetMinCost() const {
+        return min_cost_;
+    }
+
+    // Returns the largest edge cost
+    int GetMaxCost() const {
+        return max_cost_;
+    }
 };
 
-// Function implementing Dijkstra's algorithm with a constraint on the number of flights
-int Dijkstra(int n, const Graph& graph, int k, int start, int end) {
+// Dijkstra over (vertex, flights taken) states on a binary heap. Stale
+// entries are expanded again, and negative costs are tolerated.
+int DijkstraBinaryHeap(int n, const Graph& graph, int k, int start, int end) {
     // Create a 2D vector to track the shortest distances with up to k flights
     std::vector<std::vector<int>> distances(n + 1, std::vector<int>(k + 1, kMax));
     distances[start][0] = 0;
@@ -80,7 +266,441 @@ int Dijkstra(int n, const Graph& graph, int k, int start, int end) {
     return -1;
 }
 
-int main() {
+// Dijkstra over (vertex, flights taken) states on a monotone queue. State
+// `(v, f)` is keyed as `v * (k + 1) + f`; a state is expanded only when
+// popped with its final cost, so each one is settled once. Costs must be
+// non-negative.
+template <typename Queue>
+int DijkstraMonotone(int n, const Graph& graph, int k, int start, int end, Queue queue) {
+    std::vector<std::vector<int>> distances(n + 1, std::vector<int>(k + 1, kMax));
+    distances[start][0] = 0;
+    queue.Push(0, static_cast<uint64_t>(start) * (k + 1));
+
+    while (!queue.Empty()) {
+        std::pair<uint64_t, uint64_t> top = queue.Pop();
+        int cost = static_cast<int>(top.first);
+        int current = static_cast<int>(top.second / (k + 1));
+        int flights_taken = static_cast<int>(top.second % (k + 1));
+        if (cost > distances[current][flights_taken]) {
+            continue;
+        }
+
+        // The first settled state at the destination has the cheapest cost
+        if (current == end) {
+            return cost;
+        }
+
+        if (flights_taken < k) {
+            for (const Edge& edge : graph.GetAdjList()[current]) {
+                int new_cost = cost + edge.cost;
+                if (new_cost < distances[edge.to][flights_taken + 1]) {
+                    distances[edge.to][flights_taken + 1] = new_cost;
+                    queue.Push(new_cost, static_cast<uint64_t>(edge.to) * (k + 1) + flights_taken + 1);
+                }
+            }
+        }
+    }
+
+    return -1;
+}
+
+// Incoming edges of every vertex, laid out by destination in separate
+// source and cost arrays: edges into `v` are [offsets[v], offsets[v + 1])
+struct IncomingEdges {
+    std::vector<int> offsets;
+    std::vector<int> sources;
+    std::vector<int> costs;
+
+    IncomingEdges(int n, const Graph& graph) : offsets(n + 2, 0) {
+        const std::vector<std::vector<Edge>>& adj_list = graph.GetAdjList();
+        for (const std::vector<Edge>& edges : adj_list) {
+            for (const Edge& edge : edges) {
+                ++offsets[edge.to + 1];
+            }
+        }
+        for (int v = 0; v <= n; ++v) {
+            offsets[v + 1] += offsets[v];
+        }
+        sources.resize(offsets[n + 1]);
+        costs.resize(offsets[n + 1]);
+
+        std::vector<int> cursor(offsets.begin(), offsets.end() - 1);
+        for (int from = 0; from <= n; ++from) {
+            for (const Edge& edge : adj_list[from]) {
+                sources[cursor[edge.to]] = from;
+                costs[cursor[edge.to]++] = edge.cost;
+            }
+        }
+    }
+
+    int GetNumVertices() const {
+        return static_cast<int>(offsets.size()) - 2;
+    }
+};
+
+// One step of a per-vertex cost curve: `vertex` is reachable for `cost`
+// with at most `flights` flights
+struct Breakpoint {
+    int vertex;
+    int flights;
+    int cost;
+};
+
+// Layered Bellman-Ford: after round `f`, `previous[v]` is the cheapest cost
+// of reaching `v` with at most `f` flights. Each round rebuilds every entry
+// from the previous round alone, so two arrays of n + 1 ints suffice and
+// memory stays O(n + m). Each thread owns a range of destinations holding
+// about m / threads edges, so rounds need no atomics and the inner minimum
+// is a branch-free gather the compiler can vectorize. Stops early once a
+// round changes nothing and sets `*converged`. With `breakpoints`, every
+// improvement is recorded in round order.
+std::vector<int> LayeredDistances(const IncomingEdges& incoming, int k, int start, int threads,
+                                  std::vector<Breakpoint>* breakpoints = nullptr,
+                                  bool* converged = nullptr) {
+    int n = incoming.GetNumVertices();
+    const std::vector<int>& offsets = incoming.offsets;
+    int num_edges = offsets[n + 1];
+
+    threads = std::max(1, std::min(threads, n + 1));
+    std::vector<int> first_vertex(threads + 1, n + 1);
+    for (int id = 0; id < threads; ++id) {
+        int64_t target = static_cast<int64_t>(num_edges) * id / threads;
+        first_vertex[id] = static_cast<int>(
+            std::lower_bound(offsets.begin(), offsets.end() - 1, target) - offsets.begin());
+    }
+
+    std::vector<int> previous(n + 1, kMax);
+    std::vector<int> current(n + 1, kMax);
+    previous[start] = 0;
+    if (breakpoints != nullptr) {
+        breakpoints->push_back({start, 0, 0});
+    }
+    std::vector<char> changed_by_thread(threads, 0);
+    std::vector<std::vector<Breakpoint>> breakpoints_by_thread(threads);
+    int rounds = 0;
+    bool stable = false;
+    bool done = k == 0;
+    RoundBarrier barrier(threads);
+
+    auto finish_round = [&] {
+        std::swap(previous, current);
+        bool changed = false;
+        for (int id = 0; id < threads; ++id) {
+            changed = changed || changed_by_thread[id];
+            if (breakpoints != nullptr) {
+                breakpoints->insert(breakpoints->end(), breakpoints_by_thread[id].begin(),
+                                    breakpoints_by_thread[id].end());
+                breakpoints_by_thread[id].clear();
+            }
+        }
+        stable = !changed;
+        done = stable || ++rounds == k;
+    };
+
+    auto worker = [&](int id) {
+        while (true) {
+            barrier.Wait();
+            if (done) return;
+
+            const int* source = incoming.sources.data();
+            const int* cost = incoming.costs.data();
+            const int* before = previous.data();
+            bool changed = false;
+            for (int v = first_vertex[id]; v < first_vertex[id + 1]; ++v) {
+                int best = before[v];
+                for (int i = offsets[v]; i < offsets[v + 1]; ++i) {
+                    int reached = before[source[i]];
+                    int candidate = reached < kMax ? reached + cost[i] : kMax;
+                    best = std::min(best, candidate);
+                }
+                current[v] = best;
+                if (best != before[v]) {
+                    changed = true;
+                    if (breakpoints != nullptr) {
+                        breakpoints_by_thread[id].push_back({v, rounds + 1, best});
+                    }
+                }
+            }
+            changed_by_thread[id] = changed;
+
+            barrier.Wait();
+            if (id == 0) finish_round();
+        }
+    };
+
+    std::vector<std::thread> helpers;
+    for (int id = 1; id < threads; ++id) helpers.emplace_back(worker, id);
+    worker(0);
+    for (std::thread& helper : helpers) helper.join();
+
+    if (converged != nullptr) {
+        *converged = stable;
+    }
+    return previous;
+}
+
+// Layered engine for a single query, in O(n + m) memory
+int LayeredBellmanFord(int n, const Graph& graph, int k, int start, int end, int threads = 1) {
+    if (start == end) {
+        return 0;
+    }
+    std::vector<int> distances = LayeredDistances(IncomingEdges(n, graph), k, start, threads);
+    return distances[end] < kMax ? distances[end] : -1;
+}
+
+// Function implementing Dijkstra's algorithm with a constraint on the number of flights.
+// With `Engine::kAuto` the choice depends on n, m and k: the layered engine
+// takes over when the state-space table would exceed kMaxTableBytes, or
+// when (k + 1) * m exceeds kLayeredRoundsCrossover * (n + m).
+int Dijkstra(int n, const Graph& graph, int k, int start, int end,
+             QueuePolicy policy = QueuePolicy::kAuto, Engine engine = Engine::kAuto,
+             int threads = 1) {
+    if (engine == Engine::kAuto) {
+        size_t table_bytes = static_cast<size_t>(n + 1) * (static_cast<size_t>(k) + 1) * sizeof(int);
+        double state_space_edges = (static_cast<double>(k) + 1) * graph.GetNumEdges();
+        double layered_round = static_cast<double>(n) + graph.GetNumEdges();
+        engine = table_bytes > kMaxTableBytes || state_space_edges > kLayeredRoundsCrossover * layered_round
+                     ? Engine::kLayered
+                     : Engine::kStateSpace;
+    }
+    if (engine == Engine::kLayered) {
+        return LayeredBellmanFord(n, graph, k, start, end, threads);
+    }
+
+    // Monotone queues need non-negative costs
+    if (graph.GetMinCost() < 0) {
+        policy = QueuePolicy::kBinaryHeap;
+    }
+    if (policy == QueuePolicy::kAuto) {
+        policy = graph.GetMaxCost() <= kMaxBucketWeight ? QueuePolicy::kBuckets
+                                                        : QueuePolicy::kRadixHeap;
+    }
+    switch (policy) {
+        case QueuePolicy::kBinaryHeap:
+            return DijkstraBinaryHeap(n, graph, k, start, end);
+        case QueuePolicy::kBuckets:
+            return DijkstraMonotone(n, graph, k, start, end, BucketQueue<uint64_t>(graph.GetMaxCost()));
+        default:
+            return DijkstraMonotone(n, graph, k, start, end, RadixHeap<uint64_t>());
+    }
+}
+
+// Times every queue policy and the layered engine on the same query and
+// reports to stderr
+void BenchmarkQueues(int n, const Graph& graph, int k, int start, int end, int threads) {
+    using Clock = std::chrono::steady_clock;
+    const std::pair<QueuePolicy, const char*> policies[] = {
+        {QueuePolicy::kBinaryHeap, "binary heap"},
+        {QueuePolicy::kRadixHeap, "radix heap"},
+        {QueuePolicy::kBuckets, "buckets"},
+    };
+
+    int reference = 0;
+    for (const auto& policy : policies) {
+        auto started = Clock::now();
+        int result = Dijkstra(n, graph, k, start, end, policy.first, Engine::kStateSpace);
+        double seconds = std::chrono::duration<double>(Clock::now() - started).count();
+
+        if (policy.first == QueuePolicy::kBinaryHeap) {
+            reference = result;
+        }
+        std::cerr << policy.second << ": " << seconds << " s"
+                  << (result == reference ? "" : " (MISMATCH)") << "\n";
+    }
+
+    for (int count = 1;; count = std::min(count * 2, threads)) {
+        auto started = Clock::now();
+        int result = LayeredBellmanFord(n, graph, k, start, end, count);
+        double seconds = std::chrono::duration<double>(Clock::now() - started).count();
+        std::cerr << "layered, " << count << " threads: " << seconds << " s"
+                  << (result == reference ? "" : " (MISMATCH)") << "\n";
+        if (count >= threads) break;
+    }
+}
+
+// A (start, end, k) pricing query
+struct FlightQuery {
+    int k;
+    int start;
+    int end;
+};
+
+// Every cheapest cost from one source, as a function of the flight limit.
+// Only improvements are stored, sorted by vertex and then by flights, so
+// the answer for (end, k) is the last breakpoint of `end` with at most `k`
+// flights. The table answers every k up to `flights`, or every k once the
+// layered search has converged.
+class SourceTable {
+private:
+    int start_;
+    int flights_;
+    bool converged_;
+    std::vector<Breakpoint> breakpoints_;
+
+public:
+    SourceTable(int start, int flights, bool converged, std::vector<Breakpoint> breakpoints)
+        : start_(start), flights_(flights), converged_(converged), breakpoints_(std::move(breakpoints)) {
+        std::stable_sort(breakpoints_.begin(), breakpoints_.end(),
+                         [](const Breakpoint& a, const Breakpoint& b) { return a.vertex < b.vertex; });
+    }
+
+    int GetStart() const {
+        return start_;
+    }
+
+    // Whether queries with flight limit `k` can be answered from this table
+    bool Covers(int k) const {
+        return converged_ || k <= flights_;
+    }
+
+    size_t GetBytes() const {
+        return sizeof(*this) + breakpoints_.capacity() * sizeof(Breakpoint);
+    }
+
+    // Cheapest cost to `end` with at most `k` flights, or -1 if there is none
+    int Cost(int end, int k) const {
+        if (end == start_) {
+            return 0;
+        }
+        auto first = std::lower_bound(breakpoints_.begin(), breakpoints_.end(), end,
+                                      [](const Breakpoint& b, int vertex) { return b.vertex < vertex; });
+        int cost = -1;
+        for (auto it = first; it != breakpoints_.end() && it->vertex == end && it->flights <= k; ++it) {
+            cost = it->cost;
+        }
+        return cost;
+    }
+};
+
+// Answers batches of pricing queries against one graph. Queries are grouped
+// by start, and each start is computed once for the largest k asked of it.
+// Per-source tables are kept in an LRU cache bounded by `cache_bytes`, so
+// later batches that reuse a start with no larger k skip the search.
+class FlightService {
+private:
+    IncomingEdges incoming_;
+    size_t cache_bytes_;
+    int threads_;
+    std::list<SourceTable> tables_; // Most recently used first
+    std::unordered_map<int, std::list<SourceTable>::iterator> table_of_start_;
+    size_t cached_bytes_ = 0;
+    size_t lookups_ = 0;
+    size_t hits_ = 0;
+    size_t evictions_ = 0;
+
+    // Returns a table for `start` covering `k`; valid until the next call
+    const SourceTable& Table(int start, int k) {
+        ++lookups_;
+        auto cached = table_of_start_.find(start);
+        if (cached != table_of_start_.end()) {
+            if (cached->second->Covers(k)) {
+                ++hits_;
+                tables_.splice(tables_.begin(), tables_, cached->second);
+                return tables_.front();
+            }
+            cached_bytes_ -= cached->second->GetBytes();
+            tables_.erase(cached->second);
+            table_of_start_.erase(cached);
+        }
+
+        std::vector<Breakpoint> breakpoints;
+        bool converged = false;
+        LayeredDistances(incoming_, k, start, threads_, &breakpoints, &converged);
+        tables_.emplace_front(start, k, converged, std::move(breakpoints));
+        table_of_start_[start] = tables_.begin();
+        cached_bytes_ += tables_.front().GetBytes();
+
+        // Evict past the budget, but never the table about to be used
+        while (cached_bytes_ > cache_bytes_ && tables_.size() > 1) {
+            cached_bytes_ -= tables_.back().GetBytes();
+            table_of_start_.erase(tables_.back().GetStart());
+            tables_.pop_back();
+            ++evictions_;
+        }
+        return tables_.front();
+    }
+
+public:
+    FlightService(int n, const Graph& graph, size_t cache_bytes, int threads = 1)
+        : incoming_(n, graph), cache_bytes_(cache_bytes), threads_(threads) {}
+
+    // Answers every query, in input order
+    std::vector<int> Answer(const std::vector<FlightQuery>& queries) {
+        std::vector<size_t> order(queries.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(),
+                         [&](size_t a, size_t b) { return queries[a].start < queries[b].start; });
+
+        std::vector<int> answers(queries.size());
+        for (size_t first = 0; first < order.size();) {
+            size_t last = first;
+            int max_k = 0;
+            while (last < order.size() && queries[order[last]].start == queries[order[first]].start) {
+                max_k = std::max(max_k, queries[order[last]].k);
+                ++last;
+            }
+            const SourceTable& table = Table(queries[order[first]].start, max_k);
+            for (size_t i = first; i < last; ++i) {
+                answers[order[i]] = table.Cost(queries[order[i]].end, queries[order[i]].k);
+            }
+            first = last;
+        }
+        return answers;
+    }
+
+    size_t GetLookups() const {
+        return lookups_;
+    }
+
+    size_t GetHits() const {
+        return hits_;
+    }
+
+    size_t GetEvictions() const {
+        return evictions_;
+    }
+
+    size_t GetCachedBytes() const {
+        return cached_bytes_;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    bool bench = false;
+    QueuePolicy policy = QueuePolicy::kAuto;
+    Engine engine = Engine::kAuto;
+    int threads = 1;
+    bool batch = false;
+    size_t cache_megabytes = kDefaultCacheMegabytes;
+    size_t window = kDefaultWindow;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--binary-heap") {
+            policy = QueuePolicy::kBinaryHeap;
+        } else if (arg == "--radix-heap") {
+            policy = QueuePolicy::kRadixHeap;
+        } else if (arg == "--buckets") {
+            policy = QueuePolicy::kBuckets;
+        } else if (arg == "--layered") {
+            engine = Engine::kLayered;
+        } else if (arg == "--state-space") {
+            engine = Engine::kStateSpace;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::stoi(argv[++i]);
+        } else if (arg == "--batch") {
+            batch = true;
+        } else if (arg == "--cache-mb" && i + 1 < argc) {
+            cache_megabytes = std::stoul(argv[++i]);
+        } else if (arg == "--window" && i + 1 < argc) {
+            window = std::max<size_t>(1, std::stoul(argv[++i]));
+        } else if (arg == "--bench") {
+            bench = true;
+        }
+    }
+    if (threads <= 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
     int n;     // Number of vertices
     int m;     // Number of edges
     int k;     // Maximum number of flights
@@ -100,8 +720,40 @@ int main() {
         graph.AddEdge(from, to, cost);
     }
 
+    if (batch) {
+        // Batch mode: the header query is followed by a count and that many
+        // more "k start end" triplets; one answer per line. Queries reach the
+        // service `window` at a time, as separate calls would.
+        int query_count;
+        std::cin >> query_count;
+        std::vector<FlightQuery> queries = {{k, start, end}};
+        for (int i = 0; i < query_count; ++i) {
+            FlightQuery query;
+            std::cin >> query.k >> query.start >> query.end;
+            queries.push_back(query);
+        }
+
+        FlightService service(n, graph, cache_megabytes << 20, threads);
+        for (size_t first = 0; first < queries.size(); first += window) {
+            std::vector<FlightQuery> slice(queries.begin() + first,
+                                           queries.begin() + std::min(queries.size(), first + window));
+            for (int answer : service.Answer(slice)) {
+                std::cout << answer << "\n";
+            }
+        }
+        std::cerr << "lookups " << service.GetLookups() << ", hits " << service.GetHits() << " ("
+                  << 100.0 * service.GetHits() / std::max<size_t>(1, service.GetLookups())
+                  << "%), evictions " << service.GetEvictions() << ", cached "
+                  << service.GetCachedBytes() / double(1 << 20) << " MB\n";
+        return 0;
+    }
+
+    if (bench) {
+        BenchmarkQueues(n, graph, k, start, end, threads);
+    }
+
     // Run the Dijkstra algorithm and print the result
-    int result = Dijkstra(n, graph, k, start, end);
+    int result = Dijkstra(n, graph, k, start, end, policy, engine, threads);
     std::cout << result;
 
     return 0;
@@ -1,11 +1,22 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <iomanip>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <queue>
+#include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 struct Edge {
   int destination; 
   double probability; 
+  double weight;  // -log(1 - probability), so failures compose by addition
 };
 
 class Graph {
@@ -15,8 +26,28 @@ class Graph {
   explicit Graph(int nodes) : adjacency_list_(nodes + 1) {}
 
   void AddEdge(int from, int to, double probability) {
-    adjacency_list_[from].push_back({to, probability});
-    adjacency_list_[to].push_back({from, probability});
+    double weight = -std::log1p(-probability);
+    adjacency_list_[from].push_back({to, probability, weight});
+    adjacency_list_[to].push_back({from, probability, weight});
+  }
+
+  // Sets the probability of every link between `from` and `to`, adding one
+  // if there is none. Returns the smallest previous weight of those links,
+  // or infinity if the link is new.
+  double UpdateEdge(int from, int to, double probability) {
+    double weight = -std::log1p(-probability);
+    double old_weight = std::numeric_limits<double>::infinity();
+    for (int side = 0; side < 2; ++side) {
+      for (Edge& edge : adjacency_list_[side == 0 ? from : to]) {
+        if (edge.destination == (side == 0 ? to : from)) {
+          old_weight = std::min(old_weight, edge.weight);
+          edge.probability = probability;
+          edge.weight = weight;
+        }
+      }
+    }
+    if (old_weight == std::numeric_limits<double>::infinity()) AddEdge(from, to, probability);
+    return old_weight;
   }
 
   const std::vector<std::vector<Edge>>& GetAdjacencyList() const {
@@ -24,21 +55,122 @@ class Graph {
   }
 };
 
-double Dijkstra(const std::vector<std::vector<Edge>>& graph, int start_node,
-                int end_node) { 
+// Priority queue operation counts, for comparing the two Dijkstra variants
+struct HeapStats {
+  uint64_t pushes = 0;
+  uint64_t pops = 0;
+  uint64_t decrease_keys = 0;
+};
+
+// Min-heap of nodes keyed by double, with four children per slot and a
+// position index per node so a queued node's key can be lowered in place.
+// A node is in the heap at most once.
+class IndexedQuaternaryHeap {
+ public:
+  explicit IndexedQuaternaryHeap(int capacity) : position_(capacity, kAbsent) {}
+
+  bool Empty() const { return heap_.empty(); }
+
+  // Queues `node` with `key`, or lowers its key if it is already queued
+  void PushOrDecrease(int node, double key) {
+    int slot = position_[node];
+    if (slot == kAbsent) {
+      ++stats_.pushes;
+      slot = static_cast<int>(heap_.size());
+      heap_.push_back({key, node});
+    } else {
+      ++stats_.decrease_keys;
+      heap_[slot].first = key;
+    }
+    SiftUp(slot);
+  }
+
+  // Removes and returns the entry with the smallest key
+  std::pair<double, int> Pop() {
+    ++stats_.pops;
+    std::pair<double, int> top = heap_[0];
+    position_[top.second] = kAbsent;
+    std::pair<double, int> last = heap_.back();
+    heap_.pop_back();
+    if (!heap_.empty()) {
+      heap_[0] = last;
+      SiftDown(0);
+    }
+    return top;
+  }
+
+  // Empties the heap in time proportional to its size, for reuse
+  void Clear() {
+    for (const std::pair<double, int>& entry : heap_) position_[entry.second] = kAbsent;
+    heap_.clear();
+  }
+
+  const HeapStats& GetStats() const { return stats_; }
+
+ private:
+  static constexpr int kAbsent = -1;
+  static constexpr int kArity = 4;
+
+  void SiftUp(int slot) {
+    std::pair<double, int> entry = heap_[slot];
+    while (slot > 0) {
+      int parent = (slot - 1) / kArity;
+      if (heap_[parent].first <= entry.first) break;
+      Place(slot, heap_[parent]);
+      slot = parent;
+    }
+    Place(slot, entry);
+  }
+
+  void SiftDown(int slot) {
+    std::pair<double, int> entry = heap_[slot];
+    int size = static_cast<int>(heap_.size());
+    while (true) {
+      int first_child = slot * kArity + 1;
+      if (first_child >= size) break;
+      int smallest = first_child;
+      int last_child = std::min(first_child + kArity, size);
+      for (int child = first_child + 1; child < last_child; ++child) {
+        if (heap_[child].first < heap_[smallest].first) smallest = child;
+      }
+      if (entry.first <= heap_[smallest].first) break;
+      Place(slot, heap_[smallest]);
+      slot = smallest;
+    }
+    Place(slot, entry);
+  }
+
+  void Place(int slot, const std::pair<double, int>& entry) {
+    heap_[slot] = entry;
+    position_[entry.second] = slot;
+  }
+
+  std::vector<std::pair<double, int>> heap_;
+  std::vector<int> position_;
+  HeapStats stats_;
+};
+
+// Original formulation: failure probabilities composed as p + q - p*q on a
+// binary heap, with stale entries expanded again and no early exit. Kept for
+// comparison.
+double DijkstraProbabilitySpace(const std::vector<std::vector<Edge>>& graph, int start_node,
+                                int end_node, HeapStats* stats = nullptr) { 
   std::vector<double> min_probability(graph.size(), 1); 
   min_probability[start_node] = 0;
+  HeapStats counts;
 
   std::priority_queue<std::pair<double, int>,
                       std::vector<std::pair<double, int>>,
                       std::greater<std::pair<double, int>>>
       priority_queue; 
   priority_queue.push({0, start_node});
+  ++counts.pushes;
 
   while (!priority_queue.empty()) {
     double current_probability = priority_queue.top().first; 
     int current_node = priority_queue.top().second; 
     priority_queue.pop();
+    ++counts.pops;
 
     for (const Edge& edge : graph[current_node]) {
       double new_probability = current_probability + edge.probability -
@@ -46,14 +178,282 @@ double Dijkstra(const std::vector<std::vector<Edge>>& graph, int start_node,
       if (new_probability < min_probability[edge.destination]) {
         min_probability[edge.destination] = new_probability;
         priority_queue.push({new_probability, edge.destination});
+        ++counts.pushes;
       }
     }
   }
 
+  if (stats != nullptr) *stats = counts;
   return min_probability[end_node];
 }
 
-int main() {
+// Distance array, heap and target marks for repeated single-source
+// searches over one graph. Only the entries a search touched are reset
+// afterwards, so back-to-back searches cost nothing beyond their own work.
+//
+// Since 1 - P(path fails) is the product of the 1 - p, the shortest path
+// under additive weights -log(1 - p) is the most reliable one. Answers
+// are not converted back from the distance: each node also carries its
+// failure probability, composed along the path as f + p - f p in the same
+// order as DijkstraProbabilitySpace, so both print the same digits even on
+// rounding ties. Each node is pushed once, lowered
+// in place and settled once, and a search stops when its last target
+// settles. Unreachable targets report 1.
+class ReliabilityWorkspace {
+ public:
+  explicit ReliabilityWorkspace(int nodes)
+      : distance_(nodes, std::numeric_limits<double>::infinity()),
+        failure_(nodes, 1),
+        heap_(nodes),
+        is_target_(nodes, 0) {}
+
+  // Writes the minimum failure probability from `source` to every
+  // `targets[j]` into `row[j]`
+  void Search(const std::vector<std::vector<Edge>>& graph, int source,
+              const std::vector<int>& targets, double* row) {
+    int remaining = 0;
+    for (int target : targets) {
+      if (!is_target_[target]) {
+        is_target_[target] = 1;
+        ++remaining;
+      }
+    }
+
+    distance_[source] = 0;
+    failure_[source] = 0;
+    touched_.push_back(source);
+    heap_.PushOrDecrease(source, 0);
+
+    while (!heap_.Empty()) {
+      std::pair<double, int> top = heap_.Pop();
+      double current_distance = top.first;
+      int current_node = top.second;
+      if (is_target_[current_node] && --remaining == 0) break;
+
+      double current_failure = failure_[current_node];
+      for (const Edge& edge : graph[current_node]) {
+        double new_distance = current_distance + edge.weight;
+        if (new_distance < distance_[edge.destination]) {
+          if (distance_[edge.destination] == std::numeric_limits<double>::infinity()) {
+            touched_.push_back(edge.destination);
+          }
+          distance_[edge.destination] = new_distance;
+          failure_[edge.destination] = current_failure + edge.probability - current_failure * edge.probability;
+          heap_.PushOrDecrease(edge.destination, new_distance);
+        }
+      }
+    }
+
+    for (size_t j = 0; j < targets.size(); ++j) {
+      row[j] = failure_[targets[j]];
+      is_target_[targets[j]] = 0;
+    }
+    for (int node : touched_) {
+      distance_[node] = std::numeric_limits<double>::infinity();
+      failure_[node] = 1;
+    }
+    touched_.clear();
+    heap_.Clear();
+  }
+
+  const HeapStats& GetHeapStats() const { return heap_.GetStats(); }
+
+ private:
+  std::vector<double> distance_;
+  std::vector<double> failure_;
+  IndexedQuaternaryHeap heap_;
+  std::vector<char> is_target_;
+  std::vector<int> touched_;
+};
+
+// Minimum failure probability from `start_node` to `end_node`
+double Dijkstra(const std::vector<std::vector<Edge>>& graph, int start_node,
+                int end_node, HeapStats* stats = nullptr) { 
+  ReliabilityWorkspace workspace(static_cast<int>(graph.size()));
+  double result;
+  workspace.Search(graph, start_node, {end_node}, &result);
+  if (stats != nullptr) *stats = workspace.GetHeapStats();
+  return result;
+}
+
+// Minimum failure probability between every pair of `endpoints`, as a dense
+// row-major matrix. Rows are independent single-source searches over the
+// shared read-only graph; `threads` workers claim rows from a counter and
+// each reuses one workspace for all of its rows.
+std::vector<double> ReliabilityMatrix(const std::vector<std::vector<Edge>>& graph,
+                                      const std::vector<int>& endpoints, int threads) {
+  size_t count = endpoints.size();
+  std::vector<double> matrix(count * count);
+  std::atomic<size_t> next_row{0};
+
+  auto worker = [&] {
+    ReliabilityWorkspace workspace(static_cast<int>(graph.size()));
+    for (size_t row = next_row++; row < count; row = next_row++) {
+      workspace.Search(graph, endpoints[row], endpoints, matrix.data() + row * count);
+    }
+  };
+
+  threads = std::max(1, std::min<int>(threads, static_cast<int>(count)));
+  std::vector<std::thread> helpers;
+  for (int id = 1; id < threads; ++id) helpers.emplace_back(worker);
+  worker();
+  for (std::thread& helper : helpers) helper.join();
+  return matrix;
+}
+
+// Shortest-path tree of the log-space weights from a fixed source, kept
+// current under link updates in the style of Ramalingam and Reps. A link
+// that got cheaper can only lower distances, so the improvement is pushed
+// outward from its endpoints. A tree link that got dearer invalidates only
+// the subtree below it: those nodes are reseeded from their best neighbor
+// outside the subtree and settled again among themselves. Either way the
+// work is bounded by the nodes whose distance actually changes and their
+// links, not by the graph. Like ReliabilityWorkspace, each node also
+// carries its failure probability composed along its tree path in the
+// linear domain, which is what gets reported.
+class ShortestPathTree {
+ public:
+  ShortestPathTree(Graph& graph, int source)
+      : graph_(graph),
+        source_(source),
+        distance_(graph.GetAdjacencyList().size(), std::numeric_limits<double>::infinity()),
+        failure_(distance_.size(), 1),
+        parent_(distance_.size(), kNoParent),
+        mark_(distance_.size(), 0),
+        heap_(static_cast<int>(distance_.size())) {
+    Rebuild();
+  }
+
+  // Recomputes the whole tree from scratch
+  void Rebuild() {
+    std::fill(distance_.begin(), distance_.end(), std::numeric_limits<double>::infinity());
+    std::fill(failure_.begin(), failure_.end(), 1);
+    std::fill(parent_.begin(), parent_.end(), kNoParent);
+    distance_[source_] = 0;
+    failure_[source_] = 0;
+    heap_.PushOrDecrease(source_, 0);
+    Propagate();
+  }
+
+  // Sets the probability of the link between `from` and `to` on the graph
+  // and repairs the tree
+  void UpdateEdge(int from, int to, double probability) {
+    double old_weight = graph_.UpdateEdge(from, to, probability);
+    double weight = -std::log1p(-probability);
+
+    if (weight > old_weight) {
+      if (parent_[to] == from) {
+        Detach(to);
+      } else if (parent_[from] == to) {
+        Detach(from);
+      }
+    }
+
+    Relax(from, to, weight, probability);
+    Relax(to, from, weight, probability);
+    Propagate();
+  }
+
+  // Minimum failure probability from the source to `node`
+  double FailureProbability(int node) const { return failure_[node]; }
+
+ private:
+  static constexpr int kNoParent = -1;
+
+  // Failure probability of `from`'s path extended by a link of `probability`
+  double Extend(int from, double probability) const {
+    return failure_[from] + probability - failure_[from] * probability;
+  }
+
+  void Relax(int from, int to, double weight, double probability) {
+    double new_distance = distance_[from] + weight;
+    if (new_distance < distance_[to]) {
+      distance_[to] = new_distance;
+      failure_[to] = Extend(from, probability);
+      parent_[to] = from;
+      heap_.PushOrDecrease(to, new_distance);
+    }
+  }
+
+  // Settles everything queued, relaxing links as in Dijkstra
+  void Propagate() {
+    const std::vector<std::vector<Edge>>& graph = graph_.GetAdjacencyList();
+    while (!heap_.Empty()) {
+      int current_node = heap_.Pop().second;
+      for (const Edge& edge : graph[current_node]) {
+        Relax(current_node, edge.destination, edge.weight, edge.probability);
+      }
+    }
+  }
+
+  // Clears the distances of the subtree rooted at `root`, then reseeds each
+  // of its nodes from neighbors outside it and queues them
+  void Detach(int root) {
+    const std::vector<std::vector<Edge>>& graph = graph_.GetAdjacencyList();
+    ++generation_;
+    subtree_.assign(1, root);
+    mark_[root] = generation_;
+    for (size_t i = 0; i < subtree_.size(); ++i) {
+      for (const Edge& edge : graph[subtree_[i]]) {
+        int child = edge.destination;
+        if (parent_[child] == subtree_[i] && mark_[child] != generation_) {
+          mark_[child] = generation_;
+          subtree_.push_back(child);
+        }
+      }
+    }
+
+    for (int node : subtree_) {
+      distance_[node] = std::numeric_limits<double>::infinity();
+      failure_[node] = 1;
+      parent_[node] = kNoParent;
+    }
+    for (int node : subtree_) {
+      for (const Edge& edge : graph[node]) {
+        int neighbor = edge.destination;
+        if (mark_[neighbor] != generation_ && distance_[neighbor] + edge.weight < distance_[node]) {
+          distance_[node] = distance_[neighbor] + edge.weight;
+          failure_[node] = Extend(neighbor, edge.probability);
+          parent_[node] = neighbor;
+        }
+      }
+      if (parent_[node] != kNoParent) heap_.PushOrDecrease(node, distance_[node]);
+    }
+  }
+
+  Graph& graph_;
+  int source_;
+  std::vector<double> distance_;
+  std::vector<double> failure_;
+  std::vector<int> parent_;
+  std::vector<uint64_t> mark_;  // mark_[v] == generation_ while v is in subtree_
+  uint64_t generation_ = 0;
+  std::vector<int> subtree_;
+  IndexedQuaternaryHeap heap_;
+};
+
+int main(int argc, char* argv[]) {
+  bool heap_stats = false;
+  bool matrix = false;
+  bool updates = false;
+  bool bench = false;
+  int threads = 1;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--heap-stats") {
+      heap_stats = true;
+    } else if (arg == "--matrix") {
+      matrix = true;
+    } else if (arg == "--updates") {
+      updates = true;
+    } else if (arg == "--bench") {
+      bench = true;
+    } else if (arg == "--threads" && i + 1 < argc) {
+      threads = std::stoi(argv[++i]);
+    }
+  }
+  if (threads <= 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
   int num_nodes; 
   int num_edges; 
   int start_node; 
@@ -71,7 +471,89 @@ int main() {
   }
 
   const auto& adjacency_list = graph.GetAdjacencyList();
-  double result = Dijkstra(adjacency_list, start_node, end_node);
+
+  // Matrix mode: the edges are followed by a count and that many endpoints;
+  // prints one row of failure probabilities per endpoint
+  if (matrix) {
+    int endpoint_count;
+    std::cin >> endpoint_count;
+    std::vector<int> endpoints(endpoint_count);
+    for (int& endpoint : endpoints) std::cin >> endpoint;
+
+    std::vector<double> probabilities = ReliabilityMatrix(adjacency_list, endpoints, threads);
+    std::cout << std::setprecision(2);
+    for (int row = 0; row < endpoint_count; ++row) {
+      for (int column = 0; column < endpoint_count; ++column) {
+        std::cout << probabilities[static_cast<size_t>(row) * endpoint_count + column]
+                  << (column + 1 < endpoint_count ? ' ' : '\n');
+      }
+    }
+    return 0;
+  }
+
+  // Update mode: the edges are followed by a count and that many
+  // "from to probability" link updates; prints the answer before and after
+  // each update, and the average repair latency to stderr. With --bench a
+  // full recomputation is timed after every update as well, and each answer
+  // is checked against the default mode's.
+  if (updates) {
+    using Clock = std::chrono::steady_clock;
+    int update_count;
+    std::cin >> update_count;
+    ShortestPathTree tree(graph, start_node);
+    std::unique_ptr<Graph> recomputed_graph;
+    std::unique_ptr<ShortestPathTree> recomputed;
+    if (bench) {
+      recomputed_graph.reset(new Graph(graph));
+      recomputed.reset(new ShortestPathTree(*recomputed_graph, start_node));
+    }
+
+    double repair_seconds = 0;
+    double rebuild_seconds = 0;
+    double max_difference = 0;
+    std::cout << std::setprecision(2) << tree.FailureProbability(end_node) << "\n";
+    for (int i = 0; i < update_count; ++i) {
+      int source_node; 
+      int target_node; 
+      double probability_percentage; 
+      std::cin >> source_node >> target_node >> probability_percentage;
+
+      auto started = Clock::now();
+      tree.UpdateEdge(source_node, target_node, probability_percentage / 100);
+      repair_seconds += std::chrono::duration<double>(Clock::now() - started).count();
+      std::cout << tree.FailureProbability(end_node) << "\n";
+
+      if (bench) {
+        recomputed_graph->UpdateEdge(source_node, target_node, probability_percentage / 100);
+        started = Clock::now();
+        recomputed->Rebuild();
+        rebuild_seconds += std::chrono::duration<double>(Clock::now() - started).count();
+        double expected = Dijkstra(recomputed_graph->GetAdjacencyList(), start_node, end_node);
+        max_difference = std::max(max_difference, std::fabs(tree.FailureProbability(end_node) - expected));
+      }
+    }
+
+    int divisor = std::max(1, update_count);
+    std::cerr << "incremental repair: " << repair_seconds / divisor * 1e6 << " us per update\n";
+    if (bench) {
+      std::cerr << "full recomputation: " << rebuild_seconds / divisor * 1e6 << " us per update\n"
+                << "max difference: " << max_difference << "\n";
+    }
+    return 0;
+  }
+
+  HeapStats stats;
+  double result = Dijkstra(adjacency_list, start_node, end_node, &stats);
+
+  if (heap_stats) {
+    HeapStats legacy;
+    double legacy_result = DijkstraProbabilitySpace(adjacency_list, start_node, end_node, &legacy);
+    std::cerr << "probability space, binary heap: " << legacy.pushes << " pushes, " << legacy.pops
+              << " pops\n"
+              << "log space, 4-ary heap: " << stats.pushes << " pushes, " << stats.pops << " pops, "
+              << stats.decrease_keys << " decrease-keys\n"
+              << "difference: " << std::fabs(result - legacy_result) << "\n";
+  }
 
   std::cout << std::setprecision(2) << result << std::endl;
 
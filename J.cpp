@@ -1,24 +1,303 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <mutex>
+#include <new>
+#include <random>
+#include <utility>
+#include <string>
+#include <thread>
 #include <vector>
 
-const int BITS_PER_INT = 32;
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BITSET_HAS_SIMD_KERNELS 1
+#endif
+
+const int BITS_PER_WORD = 64;
+
+// Rows are padded to whole 64-byte lines so the vector kernels need
+// neither unaligned loads nor a scalar tail
+const size_t WORD_ALIGNMENT = 64;
+const size_t WORDS_PER_LINE = WORD_ALIGNMENT / sizeof(uint64_t);
+
+// Target size of the block of intermediate rows that ComputeClosure keeps
+// hot in cache while sweeping the other rows
+const size_t CLOSURE_BLOCK_BYTES = 256 << 10;
+
+// ClosureBackend::kAuto uses the condensation when at most this fraction
+// of the n^2 possible edges is present. Measured at n = 4000, condensation
+// is far ahead below it and Warshall only wins on near-complete DAGs.
+const double CONDENSATION_MAX_DENSITY = 0.125;
+
+// Matrices up to this size are closed with plain Warshall inside the
+// divide-and-conquer closure
+const int STAR_BASE_SIZE = 512;
+
+// ClosureBackend::kAuto prefers Four Russians to Warshall for dense inputs
+// from this many vertices on
+const int FOUR_RUSSIANS_MIN_SIZE = 2048;
+
+// Randomized interval labelings ReachabilityIndex keeps per component;
+// each extra one costs two ints per component and cuts more searches
+const int INDEX_TRAVERSALS = 3;
+
+// BenchmarkIndex() skips the closure above this many bytes of rows
+const double BENCH_CLOSURE_MAX_BYTES = 2e9;
+
+// DisplayPaths() hands the output to stdio in pieces of this size
+const size_t OUTPUT_BUFFER_BYTES = 4 << 20;
+
+// Leading bytes of the packed binary closure written by WritePathsBinary()
+const char BINARY_CLOSURE_MAGIC[8] = {'J', 'C', 'L', 'O', 'S', 'E', '0', '1'};
+
+enum class ClosureBackend {
+  kWarshall,      // blocked Warshall over the whole matrix
+  kCondensation,  // one row per strongly connected component, filled in reverse topological order
+  kFourRussians,  // divide-and-conquer closure on Four-Russians boolean products
+  kAuto,          // condensation unless the input is dense, then Four Russians or, when small, Warshall
+};
+
+template <typename T>
+struct AlignedAllocator {
+  using value_type = T;
+
+  AlignedAllocator() = default;
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U>&) {}
+
+  T* allocate(size_t count) {
+    size_t bytes = (count * sizeof(T) + WORD_ALIGNMENT - 1) / WORD_ALIGNMENT * WORD_ALIGNMENT;
+    void* memory = std::aligned_alloc(WORD_ALIGNMENT, std::max(bytes, WORD_ALIGNMENT));
+    if (memory == nullptr) throw std::bad_alloc();
+    return static_cast<T*>(memory);
+  }
+
+  void deallocate(T* pointer, size_t) { std::free(pointer); }
+
+  template <typename U>
+  bool operator==(const AlignedAllocator<U>&) const { return true; }
+  template <typename U>
+  bool operator!=(const AlignedAllocator<U>&) const { return false; }
+};
+
+// destination[i] |= source[i] for `words` words, a multiple of
+// WORDS_PER_LINE, on line-aligned arrays
+using OrKernel = void (*)(uint64_t* destination, const uint64_t* source, size_t words);
+
+static void OrWordsScalar(uint64_t* destination, const uint64_t* source, size_t words) {
+  for (size_t i = 0; i < words; ++i) {
+    destination[i] |= source[i];
+  }
+}
+
+#ifdef BITSET_HAS_SIMD_KERNELS
+__attribute__((target("avx2"))) static void OrWordsAvx2(uint64_t* destination, const uint64_t* source,
+                                                        size_t words) {
+  for (size_t i = 0; i < words; i += 8) {
+    __m256i* out = reinterpret_cast<__m256i*>(destination + i);
+    const __m256i* in = reinterpret_cast<const __m256i*>(source + i);
+    _mm256_store_si256(out, _mm256_or_si256(_mm256_load_si256(out), _mm256_load_si256(in)));
+    _mm256_store_si256(out + 1, _mm256_or_si256(_mm256_load_si256(out + 1), _mm256_load_si256(in + 1)));
+  }
+}
+
+__attribute__((target("avx512f"))) static void OrWordsAvx512(uint64_t* destination, const uint64_t* source,
+                                                             size_t words) {
+  for (size_t i = 0; i < words; i += 8) {
+    __m512i value = _mm512_or_si512(_mm512_load_si512(destination + i), _mm512_load_si512(source + i));
+    _mm512_store_si512(destination + i, value);
+  }
+}
+#endif
+
+// Picks the widest OR kernel the CPU supports, once
+struct OrDispatch {
+  OrKernel kernel = OrWordsScalar;
+  const char* name = "scalar";
+
+  OrDispatch() {
+#ifdef BITSET_HAS_SIMD_KERNELS
+    if (__builtin_cpu_supports("avx512f")) {
+      kernel = OrWordsAvx512;
+      name = "avx512";
+    } else if (__builtin_cpu_supports("avx2")) {
+      kernel = OrWordsAvx2;
+      name = "avx2";
+    }
+#endif
+  }
+
+  static const OrDispatch& Get() {
+    static const OrDispatch dispatch;
+    return dispatch;
+  }
+};
+
+// Writes the bits of `words` words, lowest first, as one '0' or '1' byte
+// each: 64 * `words` bytes at `out`
+using ExpandKernel = void (*)(const uint64_t* bits, size_t words, char* out);
+
+// Text for every byte value, lowest bit first
+struct ByteDigits {
+  char digits[256][8];
+
+  ByteDigits() {
+    for (int value = 0; value < 256; ++value) {
+      for (int bit = 0; bit < 8; ++bit) digits[value][bit] = static_cast<char>('0' + ((value >> bit) & 1));
+    }
+  }
+};
+
+static void ExpandWordsTable(const uint64_t* bits, size_t words, char* out) {
+  static const ByteDigits table;
+  for (size_t i = 0; i < words; ++i) {
+    uint64_t word = bits[i];
+    for (int byte = 0; byte < 8; ++byte, out += 8, word >>= 8) {
+      std::memcpy(out, table.digits[word & 0xff], 8);
+    }
+  }
+}
+
+#ifdef BITSET_HAS_SIMD_KERNELS
+// Broadcasts each half word, moves byte k of it to output bytes 8k..8k+7
+// and compares against the bit each output byte stands for
+__attribute__((target("avx2"))) static void ExpandWordsAvx2(const uint64_t* bits, size_t words, char* out) {
+  const __m256i spread = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                          2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+  const __m256i select = _mm256_set1_epi64x(static_cast<int64_t>(0x8040201008040201ull));
+  const __m256i zeros = _mm256_set1_epi8('0');
+  for (size_t i = 0; i < words; ++i) {
+    for (int half = 0; half < 2; ++half, out += 32) {
+      __m256i value = _mm256_set1_epi32(static_cast<int>(bits[i] >> (32 * half)));
+      __m256i set = _mm256_cmpeq_epi8(_mm256_and_si256(_mm256_shuffle_epi8(value, spread), select), select);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_sub_epi8(zeros, set));
+    }
+  }
+}
+#endif
+
+// Picks the bit-to-text kernel once
+struct ExpandDispatch {
+  ExpandKernel kernel = ExpandWordsTable;
+  const char* name = "table";
+
+  ExpandDispatch() {
+#ifdef BITSET_HAS_SIMD_KERNELS
+    if (__builtin_cpu_supports("avx2")) {
+      kernel = ExpandWordsAvx2;
+      name = "avx2";
+    }
+#endif
+  }
+
+  static const ExpandDispatch& Get() {
+    static const ExpandDispatch dispatch;
+    return dispatch;
+  }
+};
+
+// Collects output in one large buffer and passes it to `file` whenever it
+// fills up, so stdio issues a single write per OUTPUT_BUFFER_BYTES
+class OutputBuffer {
+ public:
+  explicit OutputBuffer(std::FILE* file) : file_(file), buffer_(OUTPUT_BUFFER_BYTES) {}
+  ~OutputBuffer() { Flush(); }
+
+  // Room for at least `bytes` more bytes, at most OUTPUT_BUFFER_BYTES
+  char* Reserve(size_t bytes) {
+    if (size_ + bytes > buffer_.size()) Flush();
+    return buffer_.data() + size_;
+  }
+
+  // Keeps `bytes` bytes written at the last Reserve()
+  void Commit(size_t bytes) { size_ += bytes; }
+
+  void Write(const void* data, size_t bytes) {
+    const char* in = static_cast<const char*>(data);
+    while (bytes > 0) {
+      size_t chunk = std::min(bytes, buffer_.size());
+      std::memcpy(Reserve(chunk), in, chunk);
+      Commit(chunk);
+      in += chunk;
+      bytes -= chunk;
+    }
+  }
+
+  void Flush() {
+    if (size_ > 0) std::fwrite(buffer_.data(), 1, size_, file_);
+    size_ = 0;
+    std::fflush(file_);
+  }
+
+ private:
+  std::FILE* file_;
+  std::vector<char> buffer_;
+  size_t size_ = 0;
+};
 
 class CustomBitset {
  public:
   explicit CustomBitset(int size)
-      : size_(size), bits_((size + BITS_PER_INT - 1) / BITS_PER_INT, 0) {}
+      : size_(size),
+        bits_((size + BITS_PER_WORD * WORDS_PER_LINE - 1) / (BITS_PER_WORD * WORDS_PER_LINE) * WORDS_PER_LINE,
+              0) {}
 
   void set(int position) {
-    bits_[position / BITS_PER_INT] |= (1u << (position % BITS_PER_INT));
+    bits_[position / BITS_PER_WORD] |= (uint64_t(1) << (position % BITS_PER_WORD));
+  }
+
+  void reset(int position) {
+    bits_[position / BITS_PER_WORD] &= ~(uint64_t(1) << (position % BITS_PER_WORD));
   }
 
   bool test(int position) const {
-    return (bits_[position / BITS_PER_INT] & (1u << (position % BITS_PER_INT))) != 0;
+    return (bits_[position / BITS_PER_WORD] & (uint64_t(1) << (position % BITS_PER_WORD))) != 0;
+  }
+
+  // Smallest set position at or after `from`, or -1 if there is none
+  int find_next(int from) const {
+    size_t word = from / BITS_PER_WORD;
+    if (from >= size_) return -1;
+    uint64_t bits = bits_[word] & (~uint64_t(0) << (from % BITS_PER_WORD));
+    while (bits == 0) {
+      if (++word == bits_.size()) return -1;
+      bits = bits_[word];
+    }
+    int position = static_cast<int>(word * BITS_PER_WORD + __builtin_ctzll(bits));
+    return position < size_ ? position : -1;
+  }
+
+  int count() const {
+    int total = 0;
+    for (uint64_t word : bits_) total += __builtin_popcountll(word);
+    return total;
   }
 
   void operator|=(const CustomBitset& other) {
-    for (int i = 0; i < bits_.size(); ++i) {
-      bits_[i] |= other.bits_[i];
+    OrDispatch::Get().kernel(bits_.data(), other.bits_.data(), bits_.size());
+  }
+
+  // Storage in words, padded past `size()` with zeros to a whole line
+  size_t word_count() const { return bits_.size(); }
+  uint64_t* data() { return bits_.data(); }
+  const uint64_t* data() const { return bits_.data(); }
+
+  // Appends the bits as '0'/'1' text, a whole word at a time
+  void WriteText(OutputBuffer& output) const {
+    const size_t CHUNK_WORDS = OUTPUT_BUFFER_BYTES / 4 / BITS_PER_WORD;
+    ExpandKernel expand = ExpandDispatch::Get().kernel;
+    size_t words = (size_ + BITS_PER_WORD - 1) / BITS_PER_WORD;
+    for (size_t first = 0; first < words; first += CHUNK_WORDS) {
+      size_t count = std::min(CHUNK_WORDS, words - first);
+      size_t digits = std::min(count * BITS_PER_WORD, size_ - first * BITS_PER_WORD);
+      expand(bits_.data() + first, count, output.Reserve(count * BITS_PER_WORD));
+      output.Commit(digits);
     }
   }
 
@@ -31,54 +310,864 @@ class CustomBitset {
 
  private:
   int size_;
-  std::vector<unsigned int> bits_;
+  std::vector<uint64_t, AlignedAllocator<uint64_t>> bits_;
+};
+
+// Reusable barrier for threads that advance in lockstep phases
+class PhaseBarrier {
+ public:
+  explicit PhaseBarrier(int threads) : threads_(threads) {}
+
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint64_t generation = generation_;
+    if (++arrived_ == threads_) {
+      arrived_ = 0;
+      ++generation_;
+      released_.notify_all();
+    } else {
+      released_.wait(lock, [&] { return generation_ != generation; });
+    }
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable released_;
+  int threads_;
+  int arrived_ = 0;
+  uint64_t generation_ = 0;
+};
+
+// Dense boolean matrix in one line-aligned allocation, rows padded to whole
+// lines like CustomBitset so the OR kernels apply to rows and row slices
+class BitMatrix {
+ public:
+  BitMatrix(int rows, int columns)
+      : rows_(rows),
+        columns_(columns),
+        stride_((columns + BITS_PER_WORD * WORDS_PER_LINE - 1) / (BITS_PER_WORD * WORDS_PER_LINE) *
+                WORDS_PER_LINE),
+        bits_(static_cast<size_t>(rows) * stride_, 0) {}
+
+  int rows() const { return rows_; }
+  int columns() const { return columns_; }
+  size_t stride() const { return stride_; }
+  uint64_t* row(int r) { return bits_.data() + r * stride_; }
+  const uint64_t* row(int r) const { return bits_.data() + r * stride_; }
+
+  void set(int r, int c) { row(r)[c / BITS_PER_WORD] |= uint64_t(1) << (c % BITS_PER_WORD); }
+  bool test(int r, int c) const { return (row(r)[c / BITS_PER_WORD] >> (c % BITS_PER_WORD)) & 1; }
+
+  void operator|=(const BitMatrix& other) {
+    OrDispatch::Get().kernel(bits_.data(), other.bits_.data(), bits_.size());
+  }
+
+  // Copy of rows [r0, r1) and columns [c0, c1); `c0` must be a multiple of 64
+  BitMatrix Block(int r0, int r1, int c0, int c1) const {
+    BitMatrix block(r1 - r0, c1 - c0);
+    size_t words = (c1 - c0 + BITS_PER_WORD - 1) / BITS_PER_WORD;
+    int tail = (c1 - c0) % BITS_PER_WORD;
+    for (int r = r0; r < r1; ++r) {
+      uint64_t* out = block.row(r - r0);
+      std::copy(row(r) + c0 / BITS_PER_WORD, row(r) + c0 / BITS_PER_WORD + words, out);
+      if (tail != 0) out[words - 1] &= (uint64_t(1) << tail) - 1;
+    }
+    return block;
+  }
+
+  // ORs `block` in with its top-left corner at (r0, c0); `c0` must be a
+  // multiple of 64
+  void OrBlock(int r0, int c0, const BitMatrix& block) {
+    size_t words = (block.columns() + BITS_PER_WORD - 1) / BITS_PER_WORD;
+    for (int r = 0; r < block.rows(); ++r) {
+      uint64_t* out = row(r0 + r) + c0 / BITS_PER_WORD;
+      const uint64_t* in = block.row(r);
+      for (size_t w = 0; w < words; ++w) out[w] |= in[w];
+    }
+  }
+
+ private:
+  int rows_;
+  int columns_;
+  size_t stride_;
+  std::vector<uint64_t, AlignedAllocator<uint64_t>> bits_;
 };
 
+// Boolean product a * b by the Method of Four Russians. The rows of `b` are
+// taken 8 at a time; a 256-entry table holds the OR of every subset of
+// them, built with one row OR per entry by extending the entry without its
+// lowest bit. Each row of `a` then needs one lookup per byte instead of
+// one OR per set bit. Four tables are built at once over a strip of
+// columns narrow enough for them to stay in cache. Rows of `a` are split
+// across `threads`, each with its own tables. Adds the number of words
+// ORed to `*words_ored`.
+BitMatrix FourRussiansMultiply(const BitMatrix& a, const BitMatrix& b, int threads,
+                               uint64_t* words_ored = nullptr) {
+  const int TABLE_BITS = 8;
+  const int TABLES = 4;
+  const size_t STRIP_WORDS = 64;
+
+  BitMatrix product(a.rows(), b.columns());
+  size_t strip_words = std::min(STRIP_WORDS, b.stride());
+  threads = std::max(1, std::min(threads, a.rows() / 64));
+  std::vector<uint64_t> ored_by_thread(threads, 0);
+
+  auto worker = [&](int id) {
+    int first = static_cast<int>(static_cast<int64_t>(a.rows()) * id / threads);
+    int last = static_cast<int>(static_cast<int64_t>(a.rows()) * (id + 1) / threads);
+    OrKernel kernel = OrDispatch::Get().kernel;
+    std::vector<uint64_t, AlignedAllocator<uint64_t>> tables(static_cast<size_t>(TABLES << TABLE_BITS) * strip_words, 0);
+    uint64_t ored = 0;
+
+    for (size_t strip = 0; strip < b.stride(); strip += strip_words) {
+      size_t width = std::min(strip_words, b.stride() - strip);
+      for (int base = 0; base < a.columns(); base += TABLES * TABLE_BITS) {
+        for (int t = 0; t < TABLES; ++t) {
+          uint64_t* table = tables.data() + (static_cast<size_t>(t) << TABLE_BITS) * strip_words;
+          std::fill(table, table + width, 0);
+          for (int subset = 1; subset < (1 << TABLE_BITS); ++subset) {
+            uint64_t* entry = table + subset * strip_words;
+            std::copy(table + (subset & (subset - 1)) * strip_words,
+                      table + (subset & (subset - 1)) * strip_words + width, entry);
+            int source = base + t * TABLE_BITS + __builtin_ctz(subset);
+            if (source < b.rows()) kernel(entry, b.row(source) + strip, width);
+          }
+          ored += width << TABLE_BITS;
+        }
+
+        for (int r = first; r < last; ++r) {
+          uint64_t bits = (a.row(r)[base / BITS_PER_WORD] >> (base % BITS_PER_WORD)) & 0xffffffffu;
+          for (int t = 0; bits != 0; ++t, bits >>= TABLE_BITS) {
+            int subset = bits & ((1 << TABLE_BITS) - 1);
+            if (subset == 0) continue;
+            const uint64_t* table = tables.data() + (static_cast<size_t>(t) << TABLE_BITS) * strip_words;
+            kernel(product.row(r) + strip, table + subset * strip_words, width);
+            ored += width;
+          }
+        }
+      }
+    }
+    ored_by_thread[id] = ored;
+  };
+
+  std::vector<std::thread> helpers;
+  for (int id = 1; id < threads; ++id) helpers.emplace_back(worker, id);
+  worker(0);
+  for (std::thread& helper : helpers) helper.join();
+
+  if (words_ored != nullptr) {
+    for (uint64_t ored : ored_by_thread) *words_ored += ored;
+  }
+  return product;
+}
+
+// Reflexive-transitive closure a* by divide and conquer. With
+// a = [A B; C D] split at a multiple of 64, E = A*, F = (D + C E B)*:
+//   a* = [E + E B F C E, E B F; F C E, F]
+// which takes two half-size closures and six half-size products, so the
+// whole closure costs a constant number of full-size products.
+BitMatrix Star(const BitMatrix& a, int threads, uint64_t* words_ored = nullptr) {
+  const int n = a.rows();
+  if (n <= STAR_BASE_SIZE) {
+    BitMatrix closed = a;
+    for (int intermediate = 0; intermediate < n; ++intermediate) {
+      for (int start = 0; start < n; ++start) {
+        if (closed.test(start, intermediate)) {
+          OrDispatch::Get().kernel(closed.row(start), closed.row(intermediate), closed.stride());
+        }
+      }
+    }
+    for (int vertex = 0; vertex < n; ++vertex) closed.set(vertex, vertex);
+    return closed;
+  }
+
+  int half = (n / 2 + BITS_PER_WORD - 1) / BITS_PER_WORD * BITS_PER_WORD;
+  BitMatrix e = Star(a.Block(0, half, 0, half), threads, words_ored);
+  BitMatrix b = a.Block(0, half, half, n);
+  BitMatrix c = a.Block(half, n, 0, half);
+
+  BitMatrix eb = FourRussiansMultiply(e, b, threads, words_ored);
+  BitMatrix f = a.Block(half, n, half, n);
+  f |= FourRussiansMultiply(c, eb, threads, words_ored);
+  f = Star(f, threads, words_ored);
+
+  BitMatrix ce = FourRussiansMultiply(c, e, threads, words_ored);
+  BitMatrix top_right = FourRussiansMultiply(eb, f, threads, words_ored);
+  BitMatrix bottom_left = FourRussiansMultiply(f, ce, threads, words_ored);
+  e |= FourRussiansMultiply(top_right, ce, threads, words_ored);
+
+  BitMatrix closed(n, n);
+  closed.OrBlock(0, 0, e);
+  closed.OrBlock(0, half, top_right);
+  closed.OrBlock(half, 0, bottom_left);
+  closed.OrBlock(half, half, f);
+  return closed;
+}
+
+// Iterative Tarjan over `n` vertices. `next_successor(vertex, cursor)`
+// returns the successor of `vertex` at `cursor` (initially 0) and advances
+// it, or -1 when there are none left. Components are numbered in the
+// order they complete, which is a reverse topological order.
+template <typename NextSuccessor>
+void FindStrongComponents(int n, NextSuccessor next_successor, std::vector<int>& component,
+                          std::vector<std::vector<int>>& members) {
+  std::vector<int> index(n, -1);
+  std::vector<int> low(n, 0);
+  std::vector<char> on_stack(n, 0);
+  std::vector<int> stack;
+  std::vector<std::pair<int, int>> calls;  // {vertex, successor cursor}
+  int counter = 0;
+
+  auto visit = [&](int vertex) {
+    index[vertex] = low[vertex] = counter++;
+    stack.push_back(vertex);
+    on_stack[vertex] = 1;
+    calls.push_back({vertex, 0});
+  };
+
+  for (int root = 0; root < n; ++root) {
+    if (index[root] != -1) continue;
+    visit(root);
+    while (!calls.empty()) {
+      int vertex = calls.back().first;
+      int next = next_successor(vertex, calls.back().second);
+      if (next != -1) {
+        if (index[next] == -1) {
+          visit(next);
+        } else if (on_stack[next]) {
+          low[vertex] = std::min(low[vertex], index[next]);
+        }
+        continue;
+      }
+
+      calls.pop_back();
+      if (!calls.empty()) low[calls.back().first] = std::min(low[calls.back().first], low[vertex]);
+      if (low[vertex] == index[vertex]) {
+        members.emplace_back();
+        int member;
+        do {
+          member = stack.back();
+          stack.pop_back();
+          on_stack[member] = 0;
+          component[member] = static_cast<int>(members.size()) - 1;
+          members.back().push_back(member);
+        } while (member != vertex);
+      }
+    }
+  }
+}
+
 class TransitiveClosure {
  public:
   explicit TransitiveClosure(const std::vector<CustomBitset>& adjacency_matrix)
       : num_vertices_(adjacency_matrix.size()), adjacency_paths_(adjacency_matrix) {}
 
-  void ComputeClosure() {
-    for (int intermediate = 0; intermediate < num_vertices_; intermediate++) {
-      for (int start = 0; start < num_vertices_; start++) {
-        if (adjacency_paths_[start].test(intermediate)) {
-          adjacency_paths_[start] |= adjacency_paths_[intermediate];
-        }
+  // Computes the closure with `backend`; `threads` applies to Warshall and
+  // Four Russians
+  void ComputeClosure(ClosureBackend backend = ClosureBackend::kAuto, int threads = 1) {
+    if (backend == ClosureBackend::kAuto) {
+      double edges = 0;
+      for (const CustomBitset& row : adjacency_paths_) edges += row.count();
+      double pairs = static_cast<double>(num_vertices_) * num_vertices_;
+      if (edges <= CONDENSATION_MAX_DENSITY * pairs) {
+        backend = ClosureBackend::kCondensation;
+      } else if (num_vertices_ >= FOUR_RUSSIANS_MIN_SIZE) {
+        backend = ClosureBackend::kFourRussians;
+      } else {
+        backend = ClosureBackend::kWarshall;
       }
     }
+    if (backend == ClosureBackend::kCondensation) {
+      ComputeCondensationClosure();
+    } else if (backend == ClosureBackend::kFourRussians) {
+      ComputeFourRussiansClosure(threads);
+    } else {
+      ComputeWarshallClosure(threads);
+    }
   }
 
+  // Bytes read and written by the row ORs of the last ComputeClosure()
+  double BytesMoved() const { return bytes_moved_; }
+
+  const std::vector<CustomBitset>& paths() const { return adjacency_paths_; }
+
+  // One line of '0'/'1' per vertex on stdout
   void DisplayPaths() const {
+    std::cout.flush();
+    OutputBuffer output(stdout);
     for (int vertex = 0; vertex < num_vertices_; vertex++) {
-      std::cout << adjacency_paths_[vertex] << std::endl;
+      adjacency_paths_[vertex].WriteText(output);
+      *output.Reserve(1) = '\n';
+      output.Commit(1);
+    }
+  }
+
+  // Packed closure on stdout: BINARY_CLOSURE_MAGIC, the vertex count and
+  // the words per row as 64-bit integers, then every row as that many
+  // 64-bit words, bit `j % 64` of word `j / 64` set if `j` is reachable.
+  // Integers are in host byte order and bits past the vertex count are 0.
+  void WritePathsBinary() const {
+    uint64_t words_per_row = (static_cast<uint64_t>(num_vertices_) + BITS_PER_WORD - 1) / BITS_PER_WORD;
+    uint64_t header[2] = {static_cast<uint64_t>(num_vertices_), words_per_row};
+    std::cout.flush();
+    OutputBuffer output(stdout);
+    output.Write(BINARY_CLOSURE_MAGIC, sizeof(BINARY_CLOSURE_MAGIC));
+    output.Write(header, sizeof(header));
+    for (const CustomBitset& row : adjacency_paths_) {
+      output.Write(row.data(), words_per_row * sizeof(uint64_t));
     }
   }
 
  private:
+  // Warshall's algorithm over blocks of intermediates. The rows of a block
+  // are first closed among themselves in order; each of them then already
+  // holds every path through the block's intermediates, so all other rows
+  // may apply the block's rows in any order relative to each other. That
+  // second phase is independent per row, so it is split across `threads`,
+  // and each row streams through the block while the block stays in cache.
+  void ComputeWarshallClosure(int threads) {
+    if (num_vertices_ == 0) return;
+    size_t row_bytes = adjacency_paths_[0].word_count() * sizeof(uint64_t);
+    int block = static_cast<int>(std::clamp<size_t>(CLOSURE_BLOCK_BYTES / row_bytes, 1, BITS_PER_WORD * 4));
+    threads = std::max(1, std::min(threads, num_vertices_));
+
+    std::vector<uint64_t> ors_by_thread(threads, 0);
+    int block_begin = 0;
+    bool done = false;
+    PhaseBarrier barrier(threads);
+
+    auto close_block = [&] {
+      int block_end = std::min(num_vertices_, block_begin + block);
+      for (int intermediate = block_begin; intermediate < block_end; intermediate++) {
+        for (int start = block_begin; start < block_end; start++) {
+          if (adjacency_paths_[start].test(intermediate)) {
+            adjacency_paths_[start] |= adjacency_paths_[intermediate];
+            ++ors_by_thread[0];
+          }
+        }
+      }
+    };
+
+    auto worker = [&](int id) {
+      while (true) {
+        barrier.Wait();
+        if (done) return;
+
+        int block_end = std::min(num_vertices_, block_begin + block);
+        int chunk = (num_vertices_ + threads - 1) / threads;
+        int first = std::min(num_vertices_, chunk * id);
+        int last = std::min(num_vertices_, first + chunk);
+        for (int start = first; start < last; start++) {
+          if (start >= block_begin && start < block_end) continue;
+          for (int intermediate = block_begin; intermediate < block_end; intermediate++) {
+            if (adjacency_paths_[start].test(intermediate)) {
+              adjacency_paths_[start] |= adjacency_paths_[intermediate];
+              ++ors_by_thread[id];
+            }
+          }
+        }
+
+        barrier.Wait();
+        if (id == 0) {
+          block_begin = block_end;
+          done = block_begin >= num_vertices_;
+          if (!done) close_block();
+        }
+      }
+    };
+
+    close_block();
+    std::vector<std::thread> helpers;
+    for (int id = 1; id < threads; ++id) helpers.emplace_back(worker, id);
+    worker(0);
+    for (std::thread& helper : helpers) helper.join();
+
+    uint64_t row_ors = 0;
+    for (uint64_t ors : ors_by_thread) row_ors += ors;
+    bytes_moved_ = 3.0 * row_ors * row_bytes;
+  }
+
+  // Closure through Star(): the reflexive-transitive closure differs from
+  // the transitive one only on the diagonal, where `v` must be kept only if
+  // some successor of `v` leads back to it
+  void ComputeFourRussiansClosure(int threads) {
+    const int n = num_vertices_;
+    BitMatrix matrix(n, n);
+    for (int vertex = 0; vertex < n; ++vertex) {
+      std::copy(adjacency_paths_[vertex].data(), adjacency_paths_[vertex].data() + matrix.stride(),
+                matrix.row(vertex));
+    }
+
+    uint64_t words_ored = 0;
+    BitMatrix closed = Star(matrix, threads, &words_ored);
+    bytes_moved_ = 3.0 * words_ored * sizeof(uint64_t);
+
+    for (int vertex = 0; vertex < n; ++vertex) {
+      CustomBitset& row = adjacency_paths_[vertex];
+      bool cyclic = false;
+      for (int next = row.find_next(0); next != -1 && !cyclic; next = row.find_next(next + 1)) {
+        cyclic = closed.test(next, vertex);
+      }
+      std::copy(closed.row(vertex), closed.row(vertex) + matrix.stride(), row.data());
+      if (!cyclic) row.reset(vertex);
+    }
+  }
+
+  // Output-sensitive closure. Every vertex of a strongly connected
+  // component reaches the same set, so Tarjan's algorithm first collapses
+  // the components; it emits them in reverse topological order, so each
+  // component's row is the OR of its (deduplicated) successors' finished
+  // rows plus its own members. A vertex then takes its component's row,
+  // minus itself when it lies on no cycle. Costs O(n^2 / 64) to scan the
+  // matrix plus one row OR per condensation edge.
+  void ComputeCondensationClosure() {
+    const int n = num_vertices_;
+    std::vector<int> component(n, -1);
+    std::vector<std::vector<int>> members;
+    FindComponents(component, members);
+
+    uint64_t row_ors = 0;
+    std::vector<CustomBitset> reach;
+    reach.reserve(members.size());
+    std::vector<int> last_source(members.size(), -1);
+    for (int id = 0; id < static_cast<int>(members.size()); ++id) {
+      reach.emplace_back(n);
+      for (int vertex : members[id]) {
+        const CustomBitset& row = adjacency_paths_[vertex];
+        for (int next = row.find_next(0); next != -1; next = row.find_next(next + 1)) {
+          int successor = component[next];
+          if (successor != id && last_source[successor] != id) {
+            last_source[successor] = id;
+            reach[id] |= reach[successor];
+            ++row_ors;
+          }
+        }
+      }
+      for (int vertex : members[id]) reach[id].set(vertex);
+    }
+    bytes_moved_ = n == 0 ? 0 : 3.0 * row_ors * reach[0].word_count() * sizeof(uint64_t);
+
+    for (int id = 0; id < static_cast<int>(members.size()); ++id) {
+      int vertex = members[id][0];
+      bool cyclic = members[id].size() > 1 || adjacency_paths_[vertex].test(vertex);
+      for (int member : members[id]) adjacency_paths_[member] = reach[id];
+      if (!cyclic) adjacency_paths_[vertex].reset(vertex);
+    }
+  }
+
+  void FindComponents(std::vector<int>& component, std::vector<std::vector<int>>& members) const {
+    FindStrongComponents(
+        num_vertices_,
+        [&](int vertex, int& cursor) {
+          int next = adjacency_paths_[vertex].find_next(cursor);
+          if (next != -1) cursor = next + 1;
+          return next;
+        },
+        component, members);
+  }
+
   int num_vertices_;
   std::vector<CustomBitset> adjacency_paths_;
+  double bytes_moved_ = 0;
+};
+
+// Answers "can u reach v?" without materializing the closure. Vertices
+// are collapsed into strongly connected components, numbered by Tarjan in
+// reverse topological order. Every component of the condensed DAG also
+// gets INDEX_TRAVERSALS GRAIL intervals [low, post]: `post` is its rank in
+// the post-order of a randomized DFS and `low` the smallest rank it
+// reaches. If u reaches v then v is numbered below u and each of v's
+// intervals lies within u's, so most negative queries end at the labels.
+// The rest are settled by a DFS over the DAG that skips every component
+// whose labels already rule v out.
+class ReachabilityIndex {
+ public:
+  // `successors[u]` lists the heads of u's edges
+  explicit ReachabilityIndex(const std::vector<std::vector<int>>& successors, uint64_t seed = 1)
+      : component_(successors.size(), -1) {
+    const int n = successors.size();
+    std::vector<std::vector<int>> members;
+    FindStrongComponents(
+        n,
+        [&](int vertex, int& cursor) {
+          return cursor < static_cast<int>(successors[vertex].size()) ? successors[vertex][cursor++] : -1;
+        },
+        component_, members);
+
+    const int components = members.size();
+    cyclic_.assign(components, 0);
+    dag_offsets_.assign(components + 1, 0);
+    std::vector<int> last_source(components, -1);
+    for (int id = 0; id < components; ++id) {
+      cyclic_[id] = members[id].size() > 1;
+      for (int vertex : members[id]) {
+        for (int next : successors[vertex]) {
+          int successor = component_[next];
+          if (successor == id) {
+            cyclic_[id] = 1;
+          } else if (last_source[successor] != id) {
+            last_source[successor] = id;
+            dag_targets_.push_back(successor);
+          }
+        }
+      }
+      dag_offsets_[id + 1] = dag_targets_.size();
+    }
+
+    labels_.assign(static_cast<size_t>(components) * INDEX_TRAVERSALS * 2, 0);
+    std::mt19937_64 random(seed);
+    for (int traversal = 0; traversal < INDEX_TRAVERSALS; ++traversal) {
+      LabelTraversal(traversal, random);
+    }
+    state_.visited.assign(components, 0);
+  }
+
+  bool Reachable(int from, int to) {
+    bool reachable = Query(from, to, state_);
+    searches_ += state_.searches;
+    state_.searches = 0;
+    return reachable;
+  }
+
+  // Sets (*answers)[i] to whether queries[i].first reaches queries[i].second,
+  // with the queries split across `threads`
+  void Reachable(const std::vector<std::pair<int, int>>& queries, std::vector<char>* answers, int threads = 1) {
+    answers->assign(queries.size(), 0);
+    threads = std::max(1, std::min<int>(threads, queries.size() / 1024));
+    std::vector<uint64_t> searches_by_thread(threads, 0);
+
+    auto worker = [&](int id) {
+      size_t first = queries.size() * id / threads;
+      size_t last = queries.size() * (id + 1) / threads;
+      SearchState state;
+      state.visited.assign(cyclic_.size(), 0);
+      for (size_t i = first; i < last; ++i) {
+        (*answers)[i] = Query(queries[i].first, queries[i].second, state);
+      }
+      searches_by_thread[id] = state.searches;
+    };
+
+    std::vector<std::thread> pool;
+    for (int id = 1; id < threads; ++id) pool.emplace_back(worker, id);
+    worker(0);
+    for (std::thread& thread : pool) thread.join();
+    for (uint64_t searches : searches_by_thread) searches_ += searches;
+  }
+
+  int num_components() const { return cyclic_.size(); }
+
+  // Queries so far that the labels could not answer
+  uint64_t searches() const { return searches_; }
+
+  // Memory held by the index, without the per-thread search marks
+  size_t IndexBytes() const {
+    return component_.size() * sizeof(int) + cyclic_.size() + dag_offsets_.size() * sizeof(int) +
+           dag_targets_.size() * sizeof(int) + labels_.size() * sizeof(int);
+  }
+
+ private:
+  struct SearchState {
+    std::vector<uint32_t> visited;  // component -> generation it was last reached in
+    uint32_t generation = 0;
+    std::vector<int> stack;
+    uint64_t searches = 0;
+  };
+
+  const int* Labels(int id) const { return labels_.data() + static_cast<size_t>(id) * INDEX_TRAVERSALS * 2; }
+
+  // Whether the labels allow component `from` to reach `to`
+  bool MayReach(int from, int to) const {
+    if (from < to) return false;
+    const int* outer = Labels(from);
+    const int* inner = Labels(to);
+    for (int i = 0; i < INDEX_TRAVERSALS * 2; i += 2) {
+      if (inner[i] < outer[i] || inner[i + 1] > outer[i + 1]) return false;
+    }
+    return true;
+  }
+
+  // Paths have at least one edge, as in the closure: a vertex reaches
+  // itself only on a cycle
+  bool Query(int from, int to, SearchState& state) const {
+    int source = component_[from];
+    int target = component_[to];
+    if (source == target) return from != to || cyclic_[source];
+    if (!MayReach(source, target)) return false;
+
+    ++state.searches;
+    if (++state.generation == 0) {
+      std::fill(state.visited.begin(), state.visited.end(), 0);
+      state.generation = 1;
+    }
+    state.stack.assign(1, source);
+    while (!state.stack.empty()) {
+      int id = state.stack.back();
+      state.stack.pop_back();
+      for (int edge = dag_offsets_[id]; edge < dag_offsets_[id + 1]; ++edge) {
+        int next = dag_targets_[edge];
+        if (next == target) return true;
+        if (state.visited[next] == state.generation || !MayReach(next, target)) continue;
+        state.visited[next] = state.generation;
+        state.stack.push_back(next);
+      }
+    }
+    return false;
+  }
+
+  // Post-order ranks from a DFS that starts at the components in random
+  // order and scans each successor list from a random offset. A component
+  // finishes after all of its successors, so `low` is final by then.
+  void LabelTraversal(int traversal, std::mt19937_64& random) {
+    const int components = cyclic_.size();
+    std::vector<int> roots(components);
+    for (int id = 0; id < components; ++id) roots[id] = id;
+    std::shuffle(roots.begin(), roots.end(), random);
+
+    std::vector<char> seen(components, 0);
+    std::vector<std::pair<int, int>> calls;  // {component, successors scanned}
+    std::vector<int> start(components, 0);
+    int rank = 0;
+    for (int root : roots) {
+      if (seen[root]) continue;
+      seen[root] = 1;
+      calls.push_back({root, 0});
+      while (!calls.empty()) {
+        int id = calls.back().first;
+        int degree = dag_offsets_[id + 1] - dag_offsets_[id];
+        if (calls.back().second == 0 && degree > 0) start[id] = random() % degree;
+        if (calls.back().second < degree) {
+          int next = dag_targets_[dag_offsets_[id] + (start[id] + calls.back().second++) % degree];
+          if (!seen[next]) {
+            seen[next] = 1;
+            calls.push_back({next, 0});
+          }
+          continue;
+        }
+
+        calls.pop_back();
+        int* label = labels_.data() + (static_cast<size_t>(id) * INDEX_TRAVERSALS + traversal) * 2;
+        label[1] = rank++;
+        label[0] = label[1];
+        for (int edge = dag_offsets_[id]; edge < dag_offsets_[id + 1]; ++edge) {
+          const int* below = labels_.data() + (static_cast<size_t>(dag_targets_[edge]) * INDEX_TRAVERSALS + traversal) * 2;
+          label[0] = std::min(label[0], below[0]);
+        }
+      }
+    }
+  }
+
+  std::vector<int> component_;
+  std::vector<char> cyclic_;
+  std::vector<int> dag_offsets_;
+  std::vector<int> dag_targets_;
+  std::vector<int> labels_;  // per component and traversal: low, post
+  SearchState state_;
+  uint64_t searches_ = 0;
 };
 
-int main() {
+// Times every backend on a random DAG of `n` vertices with about half of
+// the forward pairs as edges: nothing collapses into components and
+// Warshall does an OR for nearly every (start, intermediate) pair
+void BenchmarkBackends(int n, int threads) {
+  std::mt19937_64 random(n);
+  std::vector<CustomBitset> adjacency_matrix(n, CustomBitset(n));
+  for (int row = 0; row < n; ++row) {
+    for (int column = row + 1; column < n; ++column) {
+      if (random() & 1) adjacency_matrix[row].set(column);
+    }
+  }
+
+  const std::pair<ClosureBackend, const char*> backends[] = {
+      {ClosureBackend::kWarshall, "warshall"},
+      {ClosureBackend::kCondensation, "condensation"},
+      {ClosureBackend::kFourRussians, "four russians"},
+  };
+  std::vector<CustomBitset> reference;
+  for (const auto& backend : backends) {
+    TransitiveClosure closure(adjacency_matrix);
+    auto started = std::chrono::steady_clock::now();
+    closure.ComputeClosure(backend.first, threads);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    bool matches = true;
+    if (reference.empty()) {
+      reference = closure.paths();
+    } else {
+      for (int row = 0; row < n && matches; ++row) {
+        matches = std::equal(reference[row].data(), reference[row].data() + reference[row].word_count(),
+                             closure.paths()[row].data());
+      }
+    }
+    std::cerr << "n = " << n << ", " << backend.second << ": " << seconds << " s, "
+              << closure.BytesMoved() / seconds / 1e9 << " GB/s" << (matches ? "" : " (MISMATCH)") << "\n";
+  }
+}
+
+// Compares the closure with ReachabilityIndex on a sparse random graph of
+// `n` vertices: two forward edges per vertex plus a back edge for one
+// vertex in eight, so short cycles collapse into small components. Both
+// answer the same 2^20 random queries.
+void BenchmarkIndex(int n, int threads) {
+  const int QUERIES = 1 << 20;
+  std::mt19937_64 random(n);
+  std::vector<std::vector<int>> successors(n);
+  for (int vertex = 0; vertex + 1 < n; ++vertex) {
+    for (int edge = 0; edge < 2; ++edge) successors[vertex].push_back(vertex + 1 + random() % (n - vertex - 1));
+    if (random() % 8 == 0) successors[vertex + 1].push_back(vertex - random() % std::min(vertex + 1, 16));
+  }
+  std::vector<std::pair<int, int>> queries(QUERIES);
+  for (auto& query : queries) query = {static_cast<int>(random() % n), static_cast<int>(random() % n)};
+
+  auto seconds_since = [](std::chrono::steady_clock::time_point started) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+  };
+
+  std::vector<char> expected;
+  double closure_bytes = static_cast<double>(n) * CustomBitset(n).word_count() * sizeof(uint64_t);
+  if (closure_bytes <= BENCH_CLOSURE_MAX_BYTES) {
+    std::vector<CustomBitset> adjacency_matrix(n, CustomBitset(n));
+    for (int vertex = 0; vertex < n; ++vertex) {
+      for (int next : successors[vertex]) adjacency_matrix[vertex].set(next);
+    }
+    TransitiveClosure closure(adjacency_matrix);
+    adjacency_matrix.clear();
+    auto started = std::chrono::steady_clock::now();
+    closure.ComputeClosure(ClosureBackend::kAuto, threads);
+    double build = seconds_since(started);
+    started = std::chrono::steady_clock::now();
+    expected.resize(QUERIES);
+    for (int i = 0; i < QUERIES; ++i) expected[i] = closure.paths()[queries[i].first].test(queries[i].second);
+    double query = seconds_since(started);
+    std::cerr << "n = " << n << ", closure: build " << build << " s, " << closure_bytes / 1e6 << " MB, "
+              << query / QUERIES * 1e9 << " ns/query\n";
+  } else {
+    std::cerr << "n = " << n << ", closure: skipped, would take " << closure_bytes / 1e6 << " MB\n";
+  }
+
+  auto started = std::chrono::steady_clock::now();
+  ReachabilityIndex index(successors);
+  double build = seconds_since(started);
+  std::vector<char> answers;
+  started = std::chrono::steady_clock::now();
+  index.Reachable(queries, &answers, threads);
+  double query = seconds_since(started);
+  int64_t reachable = std::count(answers.begin(), answers.end(), 1);
+  std::cerr << "n = " << n << ", index: build " << build << " s, " << index.IndexBytes() / 1e6 << " MB, "
+            << query / QUERIES * 1e9 << " ns/query, " << index.num_components() << " components, "
+            << 100.0 * index.searches() / QUERIES << "% searched, " << 100.0 * reachable / QUERIES
+            << "% reachable" << (expected.empty() || expected == answers ? "" : " (MISMATCH)") << "\n";
+}
+
+int main(int argc, char* argv[]) {
+  int threads = 1;
+  bool bench = false;
+  bool binary = false;
+  bool index = false;
+  ClosureBackend backend = ClosureBackend::kAuto;
+  std::vector<int> bench_sizes;
+  std::vector<int> bench_index_sizes;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--warshall") {
+      backend = ClosureBackend::kWarshall;
+    } else if (arg == "--condensation") {
+      backend = ClosureBackend::kCondensation;
+    } else if (arg == "--four-russians") {
+      backend = ClosureBackend::kFourRussians;
+    } else if (arg == "--bench-backends" && i + 1 < argc) {
+      bench_sizes.push_back(std::stoi(argv[++i]));
+    } else if (arg == "--threads" && i + 1 < argc) {
+      threads = std::stoi(argv[++i]);
+    } else if (arg == "--bench") {
+      bench = true;
+    } else if (arg == "--binary") {
+      binary = true;
+    } else if (arg == "--index") {
+      index = true;
+    } else if (arg == "--bench-index" && i + 1 < argc) {
+      bench_index_sizes.push_back(std::stoi(argv[++i]));
+    }
+  }
+  if (threads <= 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  if (!bench_sizes.empty() || !bench_index_sizes.empty()) {
+    for (int n : bench_sizes) BenchmarkBackends(n, threads);
+    for (int n : bench_index_sizes) BenchmarkIndex(n, threads);
+    return 0;
+  }
+
   int num_vertices;
   std::cin >> num_vertices;
 
-  std::vector<CustomBitset> adjacency_matrix(num_vertices, CustomBitset(num_vertices));
+  // The index only needs successor lists, so it never allocates the matrix
+  std::vector<CustomBitset> adjacency_matrix(index ? 0 : num_vertices, CustomBitset(num_vertices));
+  std::vector<std::vector<int>> successors(index ? num_vertices : 0);
 
   for (int row = 0; row < num_vertices; row++) {
     std::string input_row;
     std::cin >> input_row;
     for (int column = 0; column < num_vertices; column++) {
       if (input_row[column] == '1') {
-        adjacency_matrix[row].set(column);
+        if (index) {
+          successors[row].push_back(column);
+        } else {
+          adjacency_matrix[row].set(column);
+        }
       }
     }
   }
 
+  // After the matrix: a query count, then one "from to" pair per query;
+  // prints 1 or 0 per query
+  if (index) {
+    auto started = std::chrono::steady_clock::now();
+    ReachabilityIndex reachability(successors);
+    double build = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    int num_queries;
+    std::cin >> num_queries;
+    std::vector<std::pair<int, int>> queries(num_queries);
+    for (auto& query : queries) std::cin >> query.first >> query.second;
+
+    std::vector<char> answers;
+    started = std::chrono::steady_clock::now();
+    reachability.Reachable(queries, &answers, threads);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    if (bench) {
+      std::cerr << "index: build " << build << " s, " << reachability.IndexBytes() / 1e6 << " MB, "
+                << reachability.num_components() << " components; " << num_queries << " queries, "
+                << (num_queries == 0 ? 0 : seconds / num_queries * 1e9) << " ns/query, "
+                << reachability.searches() << " searched\n";
+    }
+
+    std::cout.flush();
+    OutputBuffer output(stdout);
+    for (char answer : answers) {
+      char* out = output.Reserve(2);
+      out[0] = answer ? '1' : '0';
+      out[1] = '\n';
+      output.Commit(2);
+    }
+    return 0;
+  }
+
   TransitiveClosure closure(adjacency_matrix);
-  closure.ComputeClosure();
-  closure.DisplayPaths();
+  auto started = std::chrono::steady_clock::now();
+  closure.ComputeClosure(backend, threads);
+  if (bench) {
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    std::cerr << "closure: " << seconds << " s, " << OrDispatch::Get().name << " kernel, " << threads
+              << " threads, " << closure.BytesMoved() / seconds / 1e9 << " GB/s\n";
+  }
+  started = std::chrono::steady_clock::now();
+  if (binary) {
+    closure.WritePathsBinary();
+  } else {
+    closure.DisplayPaths();
+  }
+  if (bench) {
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    std::cerr << "output: " << seconds << " s, " << (binary ? "binary" : ExpandDispatch::Get().name) << "\n";
+  }
 
   return 0;
 }